@@ -2,12 +2,10 @@
 #include <stdio.h>  // for printf (used in debug/logging)
 
 /**
- * @brief Initializes the circular buffer by resetting indices and count.
+ * @brief Initializes the circular buffer by resetting indices.
  */
 void cb_init(circular_buffer_t *cb) {
-    cb->head = 0;
-    cb->tail = 0;
-    cb->count = 0;
+    sample_ring_init(cb);
 }
 
 /**
@@ -15,7 +13,7 @@ void cb_init(circular_buffer_t *cb) {
  * @return true if empty, false otherwise
  */
 bool cb_is_empty(circular_buffer_t *cb) {
-    return cb->count == 0;
+    return sample_ring_is_empty(cb);
 }
 
 /**
@@ -27,9 +25,7 @@ bool cb_is_empty(circular_buffer_t *cb) {
 void cb_push(circular_buffer_t *cb, sensor_data_t item) {
     if (cb_is_full(cb)) return;
 
-    cb->data[cb->head] = item;
-    cb->head = (cb->head + 1) % BUFFER_SIZE;
-    cb->count++;
+    sample_ring_push(cb, item);
 }
 
 /**
@@ -40,11 +36,7 @@ void cb_push(circular_buffer_t *cb, sensor_data_t item) {
  */
 sensor_data_t cb_pop(circular_buffer_t *cb) {
     sensor_data_t item = {0};
-    if (cb_is_empty(cb)) return item;
-
-    item = cb->data[cb->tail];
-    cb->tail = (cb->tail + 1) % BUFFER_SIZE;
-    cb->count--;
+    sample_ring_pop(cb, &item);
     return item;
 }
 
@@ -56,11 +48,9 @@ sensor_data_t cb_pop(circular_buffer_t *cb) {
  * @return true if full, false otherwise
  */
 bool cb_is_full(circular_buffer_t *cb) {
-    if (cb->count == BUFFER_SIZE) {
+    bool full = sample_ring_is_full(cb);
+    if (full) {
         printf("💥 Buffer is full! Logging should be triggered!\n");
     }
-    return cb->count == BUFFER_SIZE;
+    return full;
 }
-
-// Alternative implementations for cb_is_full() can be uncommented if needed:
-// bool cb_is_full(const circular_buffer_t *cb) { return cb->count == BUFFER_SIZE; }
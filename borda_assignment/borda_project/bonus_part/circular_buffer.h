@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <time.h>
+#include "ring.h"
 
 
 typedef struct {
@@ -13,14 +14,15 @@ typedef struct {
     time_t timestamp;
 } sensor_data_t;
 
-#define BUFFER_SIZE 3 // slow_consumer için 10'dan 3 e düşürdüm
+// Power of two; override with -DBUFFER_SIZE=N to size the buffer per build
+#ifndef BUFFER_SIZE
+#define BUFFER_SIZE 4 // slow_consumer için 10'dan 3'e, mask indeksleme için 4'e
+#endif
 
-typedef struct {
-    sensor_data_t data[BUFFER_SIZE];
-    int head;
-    int tail;
-    int count;
-} circular_buffer_t;
+// Sensor sample ring: new data is rejected (not overwritten) when full
+RING_DEFINE(sample_ring, sensor_data_t, BUFFER_SIZE, RING_REJECT)
+
+typedef sample_ring_t circular_buffer_t;
 
 void cb_init(circular_buffer_t *cb);
 bool cb_is_empty(circular_buffer_t *cb);
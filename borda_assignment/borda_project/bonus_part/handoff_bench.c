@@ -0,0 +1,493 @@
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include "circular_buffer.h"
+
+#define MAX_THREADS     32
+#define MAX_ITEM_SIZE   4096
+#define MAX_CAPACITIES  16
+#define SPIN_LIMIT      2000    // Spin-then-park: default polls before sleeping (multi-CPU hosts)
+#define YIELD_AFTER     64      // Lock-free: busy polls before yielding the CPU
+
+typedef enum { STRAT_MUTEX, STRAT_SPIN, STRAT_LOCKFREE, STRAT_COUNT } strategy_t;
+static const char *STRATEGY_NAME[STRAT_COUNT] = { "mutex+condvar", "spin-then-park", "lock-free" };
+
+typedef struct {
+    int producers;
+    int consumers;
+    uint64_t items;            // Per producer
+    uint32_t item_size;        // Bytes per item (the first 8 carry the send timestamp)
+    uint32_t capacities[MAX_CAPACITIES];
+    int n_capacities;
+    int drop;                  // 1 = drop when full (slow_consumer behaviour), 0 = block
+    uint32_t work_ns;          // Simulated processing per consumed item
+    uint32_t spin;             // Spin-then-park polls before locking (0 on a single CPU)
+    int strategies[STRAT_COUNT];
+} bench_cfg_t;
+
+/**
+ * One queue type for all strategies, sized at run time.
+ * mutex+condvar and spin-then-park use head/tail under the lock; the lock-free
+ * variant is a bounded MPMC ring with a sequence number per slot (Vyukov).
+ */
+typedef struct {
+    strategy_t strat;
+    uint32_t cap, mask, item_size;
+    uint8_t *slots;
+
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty, not_full;
+    uint64_t head, tail;               // Written under lock, read atomically while spinning
+    int parked_producers, parked_consumers;
+    uint32_t spin_limit;               // Spin-then-park polls before taking the lock
+
+    uint64_t *seq;
+    uint64_t enq_pos __attribute__((aligned(64)));
+    uint64_t deq_pos __attribute__((aligned(64)));
+
+    volatile int producers_done __attribute__((aligned(64)));
+} queue_t;
+
+typedef struct {
+    queue_t *q;
+    const bench_cfg_t *cfg;
+    uint64_t *latencies;       // Shared, one slot per consumed item
+    uint64_t *lat_index;
+    uint64_t dropped;
+    uint64_t consumed;
+} thread_ctx_t;
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+static inline void backoff(uint32_t *spins) {
+    if (++*spins < YIELD_AFTER) {
+        cpu_relax();
+    } else {
+        sched_yield();
+    }
+}
+
+static int queue_init(queue_t *q, strategy_t strat, uint32_t cap, uint32_t item_size) {
+    memset(q, 0, sizeof(*q));
+    q->strat = strat;
+    q->cap = cap;
+    q->mask = cap - 1;
+    q->item_size = item_size;
+    q->slots = malloc((size_t)cap * item_size);
+    q->seq = malloc(cap * sizeof(uint64_t));
+    if (!q->slots || !q->seq) return -1;
+
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->not_empty, NULL);
+    pthread_cond_init(&q->not_full, NULL);
+    for (uint32_t i = 0; i < cap; i++) q->seq[i] = i;
+    return 0;
+}
+
+static void queue_free(queue_t *q) {
+    pthread_mutex_destroy(&q->lock);
+    pthread_cond_destroy(&q->not_empty);
+    pthread_cond_destroy(&q->not_full);
+    free(q->slots);
+    free(q->seq);
+}
+
+// ---- mutex + condvar: the scheme rtos_bonus.c / slow_consumer.c use ----
+
+static int mutex_push(queue_t *q, const void *item, int drop) {
+    pthread_mutex_lock(&q->lock);
+    while (q->tail - q->head == q->cap) {
+        if (drop) {
+            pthread_mutex_unlock(&q->lock);
+            return 0;
+        }
+        pthread_cond_wait(&q->not_full, &q->lock);
+    }
+    memcpy(q->slots + (q->tail & q->mask) * q->item_size, item, q->item_size);
+    q->tail++;
+    pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+    return 1;
+}
+
+static int mutex_pop(queue_t *q, void *item) {
+    pthread_mutex_lock(&q->lock);
+    while (q->tail == q->head) {
+        if (q->producers_done) {
+            pthread_mutex_unlock(&q->lock);
+            return 0;
+        }
+        pthread_cond_wait(&q->not_empty, &q->lock);
+    }
+    memcpy(item, q->slots + (q->head & q->mask) * q->item_size, q->item_size);
+    q->head++;
+    pthread_cond_signal(&q->not_full);
+    pthread_mutex_unlock(&q->lock);
+    return 1;
+}
+
+// ---- spin-then-park: poll the counters first, sleep only if still blocked,
+//      and signal only when someone is actually parked ----
+
+static int spin_push(queue_t *q, const void *item, int drop) {
+    for (uint32_t i = 0; i < q->spin_limit; i++) {
+        if (__atomic_load_n(&q->tail, __ATOMIC_RELAXED) -
+            __atomic_load_n(&q->head, __ATOMIC_RELAXED) < q->cap) break;
+        cpu_relax();
+    }
+
+    pthread_mutex_lock(&q->lock);
+    while (q->tail - q->head == q->cap) {
+        if (drop) {
+            pthread_mutex_unlock(&q->lock);
+            return 0;
+        }
+        q->parked_producers++;
+        pthread_cond_wait(&q->not_full, &q->lock);
+        q->parked_producers--;
+    }
+    memcpy(q->slots + (q->tail & q->mask) * q->item_size, item, q->item_size);
+    __atomic_store_n(&q->tail, q->tail + 1, __ATOMIC_RELAXED);
+    if (q->parked_consumers) pthread_cond_signal(&q->not_empty);
+    pthread_mutex_unlock(&q->lock);
+    return 1;
+}
+
+static int spin_pop(queue_t *q, void *item) {
+    for (uint32_t i = 0; i < q->spin_limit; i++) {
+        if (__atomic_load_n(&q->tail, __ATOMIC_RELAXED) != __atomic_load_n(&q->head, __ATOMIC_RELAXED) ||
+            q->producers_done) break;
+        cpu_relax();
+    }
+
+    pthread_mutex_lock(&q->lock);
+    while (q->tail == q->head) {
+        if (q->producers_done) {
+            pthread_mutex_unlock(&q->lock);
+            return 0;
+        }
+        q->parked_consumers++;
+        pthread_cond_wait(&q->not_empty, &q->lock);
+        q->parked_consumers--;
+    }
+    memcpy(item, q->slots + (q->head & q->mask) * q->item_size, q->item_size);
+    __atomic_store_n(&q->head, q->head + 1, __ATOMIC_RELAXED);
+    if (q->parked_producers) pthread_cond_signal(&q->not_full);
+    pthread_mutex_unlock(&q->lock);
+    return 1;
+}
+
+// ---- lock-free bounded MPMC ring: a slot's sequence number says whether it
+//      is free for the producer at `pos` or filled for the consumer at `pos` ----
+
+static int lockfree_push(queue_t *q, const void *item, int drop) {
+    uint32_t spins = 0;
+    uint64_t pos = __atomic_load_n(&q->enq_pos, __ATOMIC_RELAXED);
+    uint64_t *seq;
+
+    while (1) {
+        seq = &q->seq[pos & q->mask];
+        int64_t dif = (int64_t)(__atomic_load_n(seq, __ATOMIC_ACQUIRE) - pos);
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&q->enq_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (dif < 0) {
+            if (drop) return 0;  // Full
+            backoff(&spins);
+            pos = __atomic_load_n(&q->enq_pos, __ATOMIC_RELAXED);
+        } else {
+            pos = __atomic_load_n(&q->enq_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(q->slots + (pos & q->mask) * q->item_size, item, q->item_size);
+    __atomic_store_n(seq, pos + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+static int lockfree_pop(queue_t *q, void *item) {
+    uint32_t spins = 0;
+    uint64_t pos = __atomic_load_n(&q->deq_pos, __ATOMIC_RELAXED);
+    uint64_t *seq;
+
+    while (1) {
+        seq = &q->seq[pos & q->mask];
+        int64_t dif = (int64_t)(__atomic_load_n(seq, __ATOMIC_ACQUIRE) - (pos + 1));
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&q->deq_pos, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+        } else if (dif < 0) {
+            // Empty: finished only once producers are done and nothing is left
+            if (__atomic_load_n(&q->producers_done, __ATOMIC_ACQUIRE) &&
+                (int64_t)(__atomic_load_n(seq, __ATOMIC_ACQUIRE) - (pos + 1)) < 0) return 0;
+            backoff(&spins);
+            pos = __atomic_load_n(&q->deq_pos, __ATOMIC_RELAXED);
+        } else {
+            pos = __atomic_load_n(&q->deq_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(item, q->slots + (pos & q->mask) * q->item_size, q->item_size);
+    __atomic_store_n(seq, pos + q->mask + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+static int queue_push(queue_t *q, const void *item, int drop) {
+    switch (q->strat) {
+        case STRAT_MUTEX: return mutex_push(q, item, drop);
+        case STRAT_SPIN:  return spin_push(q, item, drop);
+        default:          return lockfree_push(q, item, drop);
+    }
+}
+
+static int queue_pop(queue_t *q, void *item) {
+    switch (q->strat) {
+        case STRAT_MUTEX: return mutex_pop(q, item);
+        case STRAT_SPIN:  return spin_pop(q, item);
+        default:          return lockfree_pop(q, item);
+    }
+}
+
+/**
+ * @brief Producer: pushes items as fast as the queue accepts them, each
+ *        stamped with its send time.
+ */
+static void *producer_thread(void *arg) {
+    thread_ctx_t *ctx = arg;
+    uint8_t item[MAX_ITEM_SIZE];
+    memset(item, 0xA5, sizeof(item));
+
+    for (uint64_t i = 0; i < ctx->cfg->items; i++) {
+        uint64_t ts = now_ns();
+        memcpy(item, &ts, sizeof(ts));
+        if (!queue_push(ctx->q, item, ctx->cfg->drop)) {
+            ctx->dropped++;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Consumer: pops until the producers are done and the queue is drained,
+ *        recording the handoff latency of every item.
+ */
+static void *consumer_thread(void *arg) {
+    thread_ctx_t *ctx = arg;
+    uint8_t item[MAX_ITEM_SIZE];
+
+    while (queue_pop(ctx->q, item)) {
+        uint64_t ts, now = now_ns();
+        memcpy(&ts, item, sizeof(ts));
+        uint64_t slot = __atomic_fetch_add(ctx->lat_index, 1, __ATOMIC_RELAXED);
+        ctx->latencies[slot] = now - ts;
+        ctx->consumed++;
+
+        // Simulated processing (busy, so it does not add voluntary context switches)
+        if (ctx->cfg->work_ns) {
+            uint64_t until = now + ctx->cfg->work_ns;
+            while (now_ns() < until) cpu_relax();
+        }
+    }
+    return NULL;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static long context_switches(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_nvcsw + ru.ru_nivcsw;
+}
+
+/**
+ * @brief Runs one strategy at one capacity and prints a result row.
+ * @return 0 on success, -1 on allocation failure
+ */
+static int run(const bench_cfg_t *cfg, strategy_t strat, uint32_t cap) {
+    queue_t q;
+    uint64_t total = cfg->items * cfg->producers;
+    uint64_t *latencies = malloc(total * sizeof(uint64_t));
+    uint64_t lat_index = 0;
+    if (!latencies || queue_init(&q, strat, cap, cfg->item_size) != 0) {
+        free(latencies);
+        return -1;
+    }
+    q.spin_limit = cfg->spin;
+
+    thread_ctx_t prod[MAX_THREADS], cons[MAX_THREADS];
+    pthread_t prod_t[MAX_THREADS], cons_t[MAX_THREADS];
+
+    long csw0 = context_switches();
+    uint64_t t0 = now_ns();
+
+    for (int i = 0; i < cfg->consumers; i++) {
+        cons[i] = (thread_ctx_t){ .q = &q, .cfg = cfg, .latencies = latencies, .lat_index = &lat_index };
+        pthread_create(&cons_t[i], NULL, consumer_thread, &cons[i]);
+    }
+    for (int i = 0; i < cfg->producers; i++) {
+        prod[i] = (thread_ctx_t){ .q = &q, .cfg = cfg };
+        pthread_create(&prod_t[i], NULL, producer_thread, &prod[i]);
+    }
+
+    for (int i = 0; i < cfg->producers; i++) pthread_join(prod_t[i], NULL);
+
+    // Wake every consumer so each sees the end of the stream once the queue drains
+    pthread_mutex_lock(&q.lock);
+    __atomic_store_n(&q.producers_done, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&q.not_empty);
+    pthread_mutex_unlock(&q.lock);
+
+    for (int i = 0; i < cfg->consumers; i++) pthread_join(cons_t[i], NULL);
+
+    double elapsed = (now_ns() - t0) / 1e9;
+    long csw = context_switches() - csw0;
+
+    uint64_t consumed = 0, dropped = 0;
+    for (int i = 0; i < cfg->consumers; i++) consumed += cons[i].consumed;
+    for (int i = 0; i < cfg->producers; i++) dropped += prod[i].dropped;
+
+    qsort(latencies, consumed, sizeof(uint64_t), compare_u64);
+    uint64_t p50 = 0, p99 = 0, p999 = 0, max = 0;
+    if (consumed) {
+        p50  = latencies[(consumed - 1) * 50 / 100];
+        p99  = latencies[(consumed - 1) * 99 / 100];
+        p999 = latencies[(consumed - 1) * 999 / 1000];
+        max  = latencies[consumed - 1];
+    }
+
+    printf("%-15s %6u %12.0f %9llu %9llu %10llu %11llu %9ld %10llu\n",
+           STRATEGY_NAME[strat], cap, consumed / elapsed,
+           (unsigned long long)p50, (unsigned long long)p99, (unsigned long long)p999,
+           (unsigned long long)max, csw, (unsigned long long)dropped);
+
+    if (consumed + dropped != total) {
+        printf("❌ Lost items: %llu produced, %llu consumed, %llu dropped\n",
+               (unsigned long long)total, (unsigned long long)consumed, (unsigned long long)dropped);
+    }
+
+    queue_free(&q);
+    free(latencies);
+    return 0;
+}
+
+/**
+ * @brief Parses a comma-separated capacity list; each must be a power of two.
+ */
+static int parse_capacities(const char *s, bench_cfg_t *cfg) {
+    cfg->n_capacities = 0;
+    while (*s && cfg->n_capacities < MAX_CAPACITIES) {
+        char *end;
+        unsigned long v = strtoul(s, &end, 0);
+        if (end == s || v == 0 || (v & (v - 1)) != 0) return -1;
+        if (*end != ',' && *end != '\0') return -1;
+        cfg->capacities[cfg->n_capacities++] = (uint32_t)v;
+        s = *end == ',' ? end + 1 : end;
+    }
+    return cfg->n_capacities ? 0 : -1;
+}
+
+/**
+ * @brief Producer/consumer handoff benchmark: drives the buffer at maximum
+ *        rate and compares handoff strategies.
+ *        --producers=N --consumers=N  thread counts (default 1/1)
+ *        --items=N                    items per producer (default 1000000)
+ *        --size=BYTES                 item size, 8..4096 (default sizeof(sensor_data_t))
+ *        --capacity=A,B,...           buffer capacities to sweep (powers of two, default 4,64,1024)
+ *        --strategy=mutex|spin|lockfree   run only one strategy (default: all)
+ *        --drop                       drop on full instead of blocking (slow_consumer behaviour)
+ *        --work-ns=N                  simulated processing per consumed item
+ *        --spin=N                     spin-then-park polls before locking (default SPIN_LIMIT,
+ *                                     0 on a single CPU where spinning only delays the other side)
+ */
+int main(int argc, char *argv[]) {
+    bench_cfg_t cfg = {
+        .producers = 1, .consumers = 1, .items = 1000000, .item_size = sizeof(sensor_data_t),
+        .capacities = { 4, 64, 1024 }, .n_capacities = 3,
+        .strategies = { 1, 1, 1 }
+    };
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    cfg.spin = cpus > 1 ? SPIN_LIMIT : 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (strncmp(a, "--producers=", 12) == 0) {
+            cfg.producers = atoi(a + 12);
+        } else if (strncmp(a, "--consumers=", 12) == 0) {
+            cfg.consumers = atoi(a + 12);
+        } else if (strncmp(a, "--items=", 8) == 0) {
+            cfg.items = strtoull(a + 8, NULL, 0);
+        } else if (strncmp(a, "--size=", 7) == 0) {
+            cfg.item_size = (uint32_t)atoi(a + 7);
+        } else if (strncmp(a, "--capacity=", 11) == 0) {
+            if (parse_capacities(a + 11, &cfg) != 0) {
+                fprintf(stderr, "❌ Capacities must be powers of two: %s\n", a + 11);
+                return 1;
+            }
+        } else if (strncmp(a, "--strategy=", 11) == 0) {
+            const char *s = a + 11;
+            memset(cfg.strategies, 0, sizeof(cfg.strategies));
+            if (strcmp(s, "mutex") == 0) cfg.strategies[STRAT_MUTEX] = 1;
+            else if (strcmp(s, "spin") == 0) cfg.strategies[STRAT_SPIN] = 1;
+            else if (strcmp(s, "lockfree") == 0) cfg.strategies[STRAT_LOCKFREE] = 1;
+            else {
+                fprintf(stderr, "❌ Unknown strategy: %s\n", s);
+                return 1;
+            }
+        } else if (strcmp(a, "--drop") == 0) {
+            cfg.drop = 1;
+        } else if (strncmp(a, "--work-ns=", 10) == 0) {
+            cfg.work_ns = (uint32_t)atoi(a + 10);
+        } else if (strncmp(a, "--spin=", 7) == 0) {
+            cfg.spin = (uint32_t)atoi(a + 7);
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", a);
+            return 1;
+        }
+    }
+
+    if (cfg.producers < 1 || cfg.producers > MAX_THREADS || cfg.consumers < 1 || cfg.consumers > MAX_THREADS ||
+        cfg.item_size < sizeof(uint64_t) || cfg.item_size > MAX_ITEM_SIZE || cfg.items == 0) {
+        fprintf(stderr, "❌ Invalid configuration\n");
+        return 1;
+    }
+
+    printf("🧪 Handoff benchmark: %dP/%dC, %llu items/producer, %u B items, %s on full, %u ns work/item, "
+           "%ld CPUs, spin %u\n",
+           cfg.producers, cfg.consumers, (unsigned long long)cfg.items, cfg.item_size,
+           cfg.drop ? "drop" : "block", cfg.work_ns, cpus, cfg.spin);
+    printf("%-15s %6s %12s %9s %9s %10s %11s %9s %10s\n",
+           "Strategy", "Cap", "Items/s", "p50 ns", "p99 ns", "p99.9 ns", "max ns", "CtxSw", "Drops");
+
+    for (int c = 0; c < cfg.n_capacities; c++) {
+        for (int s = 0; s < STRAT_COUNT; s++) {
+            if (!cfg.strategies[s]) continue;
+            if (run(&cfg, (strategy_t)s, cfg.capacities[c]) != 0) {
+                fprintf(stderr, "❌ Allocation failed\n");
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
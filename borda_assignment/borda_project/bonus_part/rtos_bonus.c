@@ -5,30 +5,57 @@
 #include <string.h>
 #include <time.h>
 #include "circular_buffer.h"
+#include "signal_model.h"
+#include "worker_pool.h"
+#include "rt_sched.h"
 
 #define PRODUCE_INTERVAL 1      // Production interval (seconds)
 #define BUFFER_CAPACITY 10      // Max buffer size
+#define RT_REPORT_INTERVAL 30   // Print producer latency summary every N samples (--rt)
 
 circular_buffer_t buffer;
 pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_cond_t not_full = PTHREAD_COND_INITIALIZER;
 pthread_cond_t not_empty = PTHREAD_COND_INITIALIZER;
+uint64_t sim_seed;      // Seed for the producer's simulated channels (--seed=N)
+
+worker_pool_t pool;
+int n_workers;          // Worker threads for consumer-side processing (--workers=N)
+
+rt_config_t producer_rt, consumer_rt;
+rt_latency_t producer_latency;
 
 /**
  * @brief Producer thread function.
  *        Generates mock sensor data every second and adds it to the shared buffer.
  *        Waits if the buffer is full.
+ *        Wakes on absolute deadlines so the sampling jitter can be measured.
  */
 void* producer_thread(void* arg) {
-    srand(time(NULL));
+    // Per-thread simulators: no shared rand() state, reproducible with --seed
+    signal_model_t sim_temp, sim_hum, sim_co2;
+    signal_model_init(&sim_temp, &SIGNAL_CFG_TEMPERATURE, sim_seed + 1);
+    signal_model_init(&sim_hum,  &SIGNAL_CFG_HUMIDITY,    sim_seed + 2);
+    signal_model_init(&sim_co2,  &SIGNAL_CFG_CO2,         sim_seed + 3);
+
+    struct timespec deadline, woke;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
     while (1) {
-        sleep(PRODUCE_INTERVAL);
+        rt_timespec_add_ns(&deadline, (int64_t)PRODUCE_INTERVAL * 1000000000LL);
+        rt_sleep_until(&deadline);
+        clock_gettime(CLOCK_MONOTONIC, &woke);
+        rt_latency_record(&producer_latency, &deadline, &woke);
 
-        // Generate random sensor data
+        if (producer_rt.enabled && producer_latency.samples % RT_REPORT_INTERVAL == 0) {
+            rt_latency_print(&producer_latency, "Producer");
+        }
+
+        // Generate simulated sensor data
         sensor_data_t data = {
-            .temperature = 25.0 + (rand() % 100) / 10.0,
-            .humidity    = 40.0 + (rand() % 300) / 10.0,
-            .co2         = 400 + rand() % 200,
+            .temperature = signal_model_next(&sim_temp),
+            .humidity    = signal_model_next(&sim_hum),
+            .co2         = signal_model_next(&sim_co2),
             .timestamp   = time(NULL)
         };
 
@@ -50,9 +77,36 @@ void* producer_thread(void* arg) {
 }
 
 /**
- * @brief Consumer thread function.
- *        Continuously consumes data from the buffer and prints it.
+ * @brief Worker-side processing of one item: formatting plus the simulated
+ *        filtering delay. Runs in parallel on the worker pool.
+ */
+static void process_item(const sensor_data_t *data, wp_result_t *out) {
+    // Format timestamped output
+    char time_str[26];
+    ctime_r(&data->timestamp, time_str);
+    time_str[strcspn(time_str, "\n")] = '\0';
+
+    snprintf(out->text, sizeof(out->text),
+             "🔵 Consumer: [%s] Temp=%.2f°C | Hum=%.2f%% | CO₂=%.2f ppm",
+             time_str, data->temperature, data->humidity, data->co2);
+
+    // Simulate filtering/processing delay
+    usleep(500 * 1000);  // 500 ms
+}
+
+/**
+ * @brief Reorder-stage output: called in original timestamp order.
+ */
+static void emit_item(const wp_result_t *result) {
+    printf("%s\n", result->text);
+}
+
+/**
+ * @brief Consumer thread function
+ *        Continuously takes data from the buffer and hands it to the workers.
  *        Waits if the buffer is empty.
+ *        Processing is fanned out to the worker pool, so the buffer is
+ *        drained as fast as items arrive.
  */
 void* consumer_thread(void* arg) {
     while (1) {
@@ -67,30 +121,68 @@ void* consumer_thread(void* arg) {
         pthread_mutex_unlock(&mutex);
         pthread_cond_signal(&not_full);  // Notify producer that space is available
 
-        // Format and print timestamped output
-        char time_str[26];
-        ctime_r(&data.timestamp, time_str);
-        time_str[strcspn(time_str, "\n")] = '\0';
-
-        printf("🔵 Consumer: [%s] Temp=%.2f°C | Hum=%.2f%% | CO₂=%.2f ppm\n",
-               time_str, data.temperature, data.humidity, data.co2);
-
-        // Simulate filtering/processing delay
-        usleep(500 * 1000);  // 500 ms
+        wp_submit(&pool, &data);
     }
     return NULL;
 }
 
+/**
+ * @brief Parses the real-time options:
+ *        --rt          producer runs SCHED_FIFO at RT_DEFAULT_PRIORITY, consumer 10 below
+ *        --rt-cpu=N    pin both threads to CPU N
+ *        --seed=N      seed for the simulated sensor channels (default: current time)
+ *        --workers=N   consumer-side worker threads (default: number of CPUs)
+ */
+static void parse_args(int argc, char *argv[]) {
+    sim_seed = (uint64_t)time(NULL);
+    n_workers = wp_default_workers();
+    producer_rt.enabled = 0;
+    producer_rt.priority = RT_DEFAULT_PRIORITY;
+    producer_rt.cpu = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rt") == 0) {
+            producer_rt.enabled = 1;
+        } else if (strncmp(argv[i], "--rt-cpu=", 9) == 0) {
+            producer_rt.enabled = 1;
+            producer_rt.cpu = atoi(argv[i] + 9);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            sim_seed = strtoull(argv[i] + 7, NULL, 0);
+        } else if (strncmp(argv[i], "--workers=", 10) == 0) {
+            n_workers = atoi(argv[i] + 10);
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+        }
+    }
+
+    // Consumer must never preempt the producer's sampling deadline
+    consumer_rt = producer_rt;
+    consumer_rt.priority = producer_rt.priority - 10;
+}
+
 /**
  * @brief Initializes buffer and starts producer and consumer threads.
  */
-int main() {
+int main(int argc, char *argv[]) {
+    parse_args(argc, argv);
+    printf("🎲 Simulation seed: %llu\n", (unsigned long long)sim_seed);
     cb_init(&buffer);
+    rt_latency_init(&producer_latency);
+
+    if (producer_rt.enabled) {
+        rt_lock_memory(RT_PREFAULT_STACK);
+    }
+
+    wp_start(&pool, n_workers, process_item, emit_item);
+    printf("🧵 Consumer worker pool: %d workers\n", pool.n_workers);
 
     pthread_t producer, consumer;
     pthread_create(&producer, NULL, producer_thread, NULL);
     pthread_create(&consumer, NULL, consumer_thread, NULL);
 
+    rt_apply_thread(producer, &producer_rt);
+    rt_apply_thread(consumer, &consumer_rt);
+
     pthread_join(producer, NULL);
     pthread_join(consumer, NULL);
 
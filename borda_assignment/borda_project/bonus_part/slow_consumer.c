@@ -5,6 +5,8 @@
 #include <string.h>
 #include <time.h>
 #include "circular_buffer.h"
+#include "signal_model.h"
+#include "worker_pool.h"
 
 #define PRODUCE_INTERVAL 1      // Interval between each produced item (in seconds)
 #define BUFFER_CAPACITY 10      // Maximum capacity of the buffer
@@ -13,6 +15,8 @@ circular_buffer_t buffer;
 pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 pthread_cond_t not_full = PTHREAD_COND_INITIALIZER;
 pthread_cond_t not_empty = PTHREAD_COND_INITIALIZER;
+uint64_t sim_seed;      // Seed for the producer's simulated channels (--seed=N)
+worker_pool_t pool;
 
 /**
  * @brief Producer thread function
@@ -20,15 +24,19 @@ pthread_cond_t not_empty = PTHREAD_COND_INITIALIZER;
  *        If the buffer is full, the data is dropped and logged to file.
  */
 void* producer_thread(void* arg) {
-    srand(time(NULL));
+    // Per-thread simulators: no shared rand() state, reproducible with --seed
+    signal_model_t sim_temp, sim_hum, sim_co2;
+    signal_model_init(&sim_temp, &SIGNAL_CFG_TEMPERATURE, sim_seed + 1);
+    signal_model_init(&sim_hum,  &SIGNAL_CFG_HUMIDITY,    sim_seed + 2);
+    signal_model_init(&sim_co2,  &SIGNAL_CFG_CO2,         sim_seed + 3);
     while (1) {
         sleep(PRODUCE_INTERVAL);
 
-        // Generate random sensor data
+        // Generate simulated sensor data
         sensor_data_t data = {
-            .temperature = 25.0 + (rand() % 100) / 10.0,
-            .humidity    = 40.0 + (rand() % 300) / 10.0,
-            .co2         = 400 + rand() % 200,
+            .temperature = signal_model_next(&sim_temp),
+            .humidity    = signal_model_next(&sim_hum),
+            .co2         = signal_model_next(&sim_co2),
             .timestamp   = time(NULL)
         };
 
@@ -60,40 +68,74 @@ void* producer_thread(void* arg) {
     return NULL;
 }
 
+/**
+ * @brief Worker-side processing of one item: formatting plus the simulated
+ *        filtering delay. Runs in parallel on the worker pool.
+ */
+static void process_item(const sensor_data_t *data, wp_result_t *out) {
+    // Format timestamped output
+    char time_str[26];
+    ctime_r(&data->timestamp, time_str);
+    time_str[strcspn(time_str, "\n")] = '\0';
+
+    snprintf(out->text, sizeof(out->text),
+             "🔵 Consumer: [%s] Temp=%.2f°C | Hum=%.2f%% | CO₂=%.2f ppm",
+             time_str, data->temperature, data->humidity, data->co2);
+
+    // Simulated slow processing (2 sec per item)
+    usleep(2000 * 1000);
+}
+
+/**
+ * @brief Reorder-stage output: called in original timestamp order.
+ */
+static void emit_item(const wp_result_t *result) {
+    printf("%s\n", result->text);
+}
+
 /**
  * @brief Consumer thread function
- *        Waits for data to appear in the buffer and consumes it.
- *        Simulates slower processing to demonstrate producer-consumer imbalance.
+ *        Waits for data to appear in the buffer and hands it to the workers.
+ *        Processing is fanned out to the worker pool, so the buffer is
+ *        drained as fast as items arrive.
  */
 void* consumer_thread(void* arg) {
     while (1) {
         pthread_mutex_lock(&mutex);
+
+        // Wait until there is data in the buffer
         while (cb_is_empty(&buffer)) {
             pthread_cond_wait(&not_empty, &mutex);
         }
 
         sensor_data_t data = cb_pop(&buffer);
         pthread_mutex_unlock(&mutex);
-        pthread_cond_signal(&not_full);
-
-        // Format timestamp
-        char time_str[26];
-        ctime_r(&data.timestamp, time_str);
-        time_str[strcspn(time_str, "\n")] = '\0';
-
-        printf("🔵 Consumer: [%s] Temp=%.2f°C | Hum=%.2f%% | CO₂=%.2f ppm\n",
-               time_str, data.temperature, data.humidity, data.co2);
+        pthread_cond_signal(&not_full);  // Notify producer that space is available
 
-        // Simulated slow consumer (2 sec), to create backlog
-        usleep(2000 * 1000);
+        wp_submit(&pool, &data);
     }
     return NULL;
 }
 
 /**
  * @brief Initializes the circular buffer and starts producer and consumer threads.
+ *        Optional --seed=N makes the simulated data reproducible.
+ *        Optional --workers=N sets the consumer pool size (1 = original single consumer).
  */
-int main() {
+int main(int argc, char *argv[]) {
+    sim_seed = (uint64_t)time(NULL);
+    int n_workers = wp_default_workers();
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0)
+            sim_seed = strtoull(argv[i] + 7, NULL, 0);
+        else if (strncmp(argv[i], "--workers=", 10) == 0)
+            n_workers = atoi(argv[i] + 10);
+    }
+    printf("🎲 Simulation seed: %llu\n", (unsigned long long)sim_seed);
+
+    wp_start(&pool, n_workers, process_item, emit_item);
+    printf("🧵 Consumer worker pool: %d workers\n", pool.n_workers);
+
     cb_init(&buffer);
 
     pthread_t producer, consumer;
@@ -0,0 +1,205 @@
+#include "worker_pool.h"
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Takes the oldest task from one worker's queue.
+ * @return 1 if a task was taken, 0 if the queue was empty
+ */
+static int take_task(wp_worker_t *w, wp_task_t *task) {
+    pthread_mutex_lock(&w->lock);
+    int ok = wp_queue_pop(&w->tasks, task);
+    pthread_mutex_unlock(&w->lock);
+    return ok;
+}
+
+/**
+ * @brief Looks for work: own queue first, then steals from the other workers.
+ *        Oldest tasks are taken first so the reorder stage is never held up
+ *        waiting for an old item stuck behind newer ones.
+ */
+static int find_task(worker_pool_t *pool, int self, wp_task_t *task) {
+    if (take_task(&pool->workers[self], task)) return 1;
+
+    for (int k = 1; k < pool->n_workers; k++) {
+        int victim = (self + k) % pool->n_workers;
+        if (take_task(&pool->workers[victim], task)) {
+            __atomic_fetch_add(&pool->stolen, 1, __ATOMIC_RELAXED);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Worker thread: runs the process callback on tasks and hands the
+ *        results to the reorder stage.
+ *
+ * A worker claims a task by decrementing `pending` under idle_lock before it
+ * searches the queues, so only as many workers leave the condvar as there are
+ * tasks, and the rest keep sleeping instead of scanning empty queues.
+ */
+static void *worker_thread(void *arg) {
+    wp_thread_arg_t *ta = arg;
+    worker_pool_t *pool = ta->pool;
+    wp_task_t task;
+
+    while (1) {
+        pthread_mutex_lock(&pool->idle_lock);
+        while (pool->pending == 0 && pool->running) {
+            pthread_cond_wait(&pool->work_available, &pool->idle_lock);
+        }
+        if (pool->pending == 0 && !pool->running) {
+            pthread_mutex_unlock(&pool->idle_lock);
+            break;
+        }
+        pool->pending--;
+        pthread_mutex_unlock(&pool->idle_lock);
+
+        // The claim guarantees a queued task. A scan can still come up empty when
+        // other workers take tasks ahead of it while new ones land in queues it
+        // has already passed, so retry.
+        while (!find_task(pool, ta->index, &task)) sched_yield();
+
+        // Each seq owns its own slot, so processing writes it without the lock
+        uint32_t slot = task.seq & (WP_REORDER_SIZE - 1);
+        wp_result_t *res = &pool->results[slot];
+        res->data = task.data;
+        pool->process(&task.data, res);
+
+        pthread_mutex_lock(&pool->reorder_lock);
+        pool->ready[slot] = 1;
+        if (task.seq == pool->next_emit) {
+            pthread_cond_signal(&pool->result_ready);
+        }
+        pthread_mutex_unlock(&pool->reorder_lock);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Reorder stage: emits results in submission order, whatever order
+ *        the workers finished them in.
+ */
+static void *emitter_thread(void *arg) {
+    worker_pool_t *pool = arg;
+    wp_result_t out;
+
+    while (1) {
+        pthread_mutex_lock(&pool->reorder_lock);
+        uint32_t slot = pool->next_emit & (WP_REORDER_SIZE - 1);
+        while (!pool->ready[slot] && (pool->running || pool->next_emit != pool->next_submit)) {
+            pthread_cond_wait(&pool->result_ready, &pool->reorder_lock);
+        }
+        if (!pool->ready[slot]) {
+            pthread_mutex_unlock(&pool->reorder_lock);
+            break;  // Stopped and fully drained
+        }
+
+        out = pool->results[slot];
+        pool->ready[slot] = 0;
+        pool->next_emit++;
+        pthread_cond_signal(&pool->slot_free);
+        pthread_mutex_unlock(&pool->reorder_lock);
+
+        pool->emit(&out);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns the number of online CPUs, used as the default worker count.
+ */
+int wp_default_workers(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    if (n > WP_MAX_WORKERS) n = WP_MAX_WORKERS;
+    return (int)n;
+}
+
+/**
+ * @brief Starts N workers and the reorder/emitter thread.
+ * @param pool      Pool state
+ * @param n_workers Number of worker threads (1..WP_MAX_WORKERS)
+ * @param process   Called on a worker for each item (may be slow)
+ * @param emit      Called on the emitter thread for each result, in submission order
+ * @return 0 on success, -1 on failure
+ */
+int wp_start(worker_pool_t *pool, int n_workers, wp_process_fn process, wp_emit_fn emit) {
+    if (n_workers < 1) n_workers = 1;
+    if (n_workers > WP_MAX_WORKERS) n_workers = WP_MAX_WORKERS;
+
+    memset(pool, 0, sizeof(*pool));
+    pool->n_workers = n_workers;
+    pool->process = process;
+    pool->emit = emit;
+    pool->running = 1;
+
+    pthread_mutex_init(&pool->idle_lock, NULL);
+    pthread_cond_init(&pool->work_available, NULL);
+    pthread_mutex_init(&pool->reorder_lock, NULL);
+    pthread_cond_init(&pool->result_ready, NULL);
+    pthread_cond_init(&pool->slot_free, NULL);
+
+    for (int i = 0; i < n_workers; i++) {
+        pthread_mutex_init(&pool->workers[i].lock, NULL);
+        wp_queue_init(&pool->workers[i].tasks);
+    }
+
+    if (pthread_create(&pool->emitter, NULL, emitter_thread, pool) != 0) return -1;
+    for (int i = 0; i < n_workers; i++) {
+        pool->thread_args[i].pool = pool;
+        pool->thread_args[i].index = i;
+        if (pthread_create(&pool->threads[i], NULL, worker_thread, &pool->thread_args[i]) != 0) return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Submits one item. Blocks only when WP_REORDER_SIZE items are already
+ *        in flight, which pushes back on the caller instead of growing memory.
+ * @param pool Pool state
+ * @param data Item to process (copied)
+ */
+void wp_submit(worker_pool_t *pool, const sensor_data_t *data) {
+    pthread_mutex_lock(&pool->reorder_lock);
+    while (pool->next_submit - pool->next_emit >= WP_REORDER_SIZE) {
+        pthread_cond_wait(&pool->slot_free, &pool->reorder_lock);
+    }
+    wp_task_t task = { .seq = pool->next_submit++, .data = *data };
+    pthread_mutex_unlock(&pool->reorder_lock);
+
+    // Spread tasks round-robin; stealing evens out any imbalance
+    wp_worker_t *w = &pool->workers[task.seq % pool->n_workers];
+    pthread_mutex_lock(&w->lock);
+    wp_queue_push(&w->tasks, task);
+    pthread_mutex_unlock(&w->lock);
+
+    pthread_mutex_lock(&pool->idle_lock);
+    pool->pending++;
+    pthread_cond_signal(&pool->work_available);
+    pthread_mutex_unlock(&pool->idle_lock);
+}
+
+/**
+ * @brief Finishes all submitted work, emits it, and joins every thread.
+ */
+void wp_stop(worker_pool_t *pool) {
+    // Workers read `running` under idle_lock, the emitter under reorder_lock
+    pthread_mutex_lock(&pool->idle_lock);
+    pthread_mutex_lock(&pool->reorder_lock);
+    pool->running = 0;
+    pthread_mutex_unlock(&pool->reorder_lock);
+    pthread_cond_broadcast(&pool->work_available);
+    pthread_mutex_unlock(&pool->idle_lock);
+
+    for (int i = 0; i < pool->n_workers; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_mutex_lock(&pool->reorder_lock);
+    pthread_cond_broadcast(&pool->result_ready);
+    pthread_mutex_unlock(&pool->reorder_lock);
+    pthread_join(pool->emitter, NULL);
+}
@@ -0,0 +1,73 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "circular_buffer.h"
+#include "ring.h"
+
+#define WP_MAX_WORKERS   16
+#define WP_REORDER_SIZE  64     // Max items in flight (power of two)
+#define WP_TEXT_LEN      192    // Formatted output line per item
+
+typedef struct {
+    uint64_t seq;               // Submission order = producer timestamp order
+    sensor_data_t data;
+} wp_task_t;
+
+typedef struct {
+    sensor_data_t data;
+    char text[WP_TEXT_LEN];
+} wp_result_t;
+
+typedef void (*wp_process_fn)(const sensor_data_t *in, wp_result_t *out);
+typedef void (*wp_emit_fn)(const wp_result_t *result);
+
+// Each worker owns a queue; idle workers steal from the others
+RING_DEFINE(wp_queue, wp_task_t, WP_REORDER_SIZE, RING_REJECT)
+
+typedef struct {
+    pthread_mutex_t lock;
+    wp_queue_t tasks;
+} wp_worker_t;
+
+// Start argument of one worker thread
+typedef struct {
+    struct worker_pool *pool;
+    int index;
+} wp_thread_arg_t;
+
+typedef struct worker_pool {
+    int n_workers;
+    volatile int running;
+    wp_process_fn process;
+    wp_emit_fn emit;
+
+    pthread_t threads[WP_MAX_WORKERS];
+    wp_thread_arg_t thread_args[WP_MAX_WORKERS];
+    wp_worker_t workers[WP_MAX_WORKERS];
+
+    // Idle workers sleep here until work is submitted
+    pthread_mutex_t idle_lock;
+    pthread_cond_t work_available;
+    uint32_t pending;           // Queued tasks not yet claimed by a worker
+
+    // Reorder stage: results land in slot seq % WP_REORDER_SIZE, emitted strictly in seq order
+    pthread_t emitter;
+    pthread_mutex_t reorder_lock;
+    pthread_cond_t result_ready;
+    pthread_cond_t slot_free;
+    wp_result_t results[WP_REORDER_SIZE];
+    uint8_t ready[WP_REORDER_SIZE];
+    uint64_t next_submit;
+    uint64_t next_emit;
+
+    uint64_t stolen;            // Tasks executed by a worker other than the one they were queued on
+} worker_pool_t;
+
+int  wp_start(worker_pool_t *pool, int n_workers, wp_process_fn process, wp_emit_fn emit);
+void wp_submit(worker_pool_t *pool, const sensor_data_t *data);
+void wp_stop(worker_pool_t *pool);
+int  wp_default_workers(void);
+
+#endif // WORKER_POOL_H
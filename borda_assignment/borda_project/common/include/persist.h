@@ -0,0 +1,40 @@
+#ifndef PERSIST_H
+#define PERSIST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PERSIST_MAGIC 0x54535645u   // "EVST" little-endian
+
+// Outcome of persist_open()
+typedef enum {
+    PERSIST_FAILED   = -1,   // No file mapping; the caller keeps its state in memory
+    PERSIST_FRESH    = 0,    // New, stale or invalid file: data was zeroed
+    PERSIST_RESTORED = 1     // Valid state reattached, resume from it
+} persist_status_t;
+
+// File header, followed by the caller's data block
+typedef struct {
+    uint32_t magic;          // PERSIST_MAGIC
+    uint32_t version;        // Caller's layout version
+    uint64_t data_size;      // sizeof the caller's state struct
+    uint64_t commits;        // Number of persist_commit() calls
+    double   saved_at;       // CLOCK_REALTIME seconds of the last commit
+    uint32_t checksum;       // CRC-32 of the data block at the last commit
+    uint32_t reserved;
+} persist_header_t;
+
+typedef struct {
+    int fd;
+    size_t map_size;
+    persist_header_t *hdr;
+    void *data;              // Caller's state, updated in place
+    const char *reason;      // Why the state was not restored (PERSIST_FRESH)
+} persist_t;
+
+persist_status_t persist_open(persist_t *p, const char *path, uint32_t version,
+                              size_t data_size, double max_age_s, double now);
+void persist_commit(persist_t *p, double now);
+void persist_close(persist_t *p);
+
+#endif // PERSIST_H
@@ -0,0 +1,75 @@
+#ifndef PRNG_H
+#define PRNG_H
+
+#include <math.h>
+#include <stdint.h>
+
+// xoshiro128** — small, fast, per-instance PRNG (no global state, no locking)
+typedef struct {
+    uint32_t s[4];
+} prng_t;
+
+static inline uint32_t prng_rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+/**
+ * @brief splitmix64 step, used to expand a single seed into a full PRNG state.
+ */
+static inline uint64_t prng_splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Seeds a generator. The same seed always produces the same sequence.
+ * @param rng  Generator to seed
+ * @param seed Any 64-bit value (0 is fine)
+ */
+static inline void prng_seed(prng_t *rng, uint64_t seed) {
+    uint64_t a = prng_splitmix64(&seed);
+    uint64_t b = prng_splitmix64(&seed);
+    rng->s[0] = (uint32_t)a;
+    rng->s[1] = (uint32_t)(a >> 32);
+    rng->s[2] = (uint32_t)b;
+    rng->s[3] = (uint32_t)(b >> 32);
+}
+
+/**
+ * @brief Returns the next 32-bit random value.
+ */
+static inline uint32_t prng_next(prng_t *rng) {
+    uint32_t *s = rng->s;
+    uint32_t result = prng_rotl(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = prng_rotl(s[3], 11);
+
+    return result;
+}
+
+/**
+ * @brief Uniform float in [0, 1).
+ */
+static inline float prng_uniform(prng_t *rng) {
+    return (prng_next(rng) >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Standard normal sample (mean 0, std 1) using the Box-Muller transform.
+ */
+static inline float prng_gaussian(prng_t *rng) {
+    float u1 = prng_uniform(rng);
+    float u2 = prng_uniform(rng);
+    if (u1 < 1e-7f) u1 = 1e-7f;  // Avoid log(0)
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.28318530718f * u2);
+}
+
+#endif // PRNG_H
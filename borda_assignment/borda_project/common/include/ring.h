@@ -0,0 +1,130 @@
+#ifndef RING_H
+#define RING_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Header-only ring buffer, specialized per element type and capacity.
+ *
+ *   RING_DEFINE(float_ring, float, 64, RING_OVERWRITE)
+ *
+ * generates float_ring_t plus float_ring_init/_count/_is_empty/_is_full/
+ * _push/_pop/_push_bulk/_pop_bulk/_peek_bulk/_discard. Capacity must be a
+ * power of two: head/tail are free-running 32-bit counters and slots are found
+ * with a mask, so there is no modulo and no separate count field.
+ *
+ * Full policy is fixed at compile time:
+ *   RING_OVERWRITE  push on a full ring drops the oldest element
+ *   RING_REJECT     push on a full ring is refused and returns 0
+ */
+
+#define RING_REJECT    0
+#define RING_OVERWRITE 1
+
+#define RING_DEFINE(name, type, capacity, policy)                                   \
+                                                                                    \
+_Static_assert((capacity) > 0 && ((capacity) & ((capacity) - 1)) == 0,              \
+               #name ": capacity must be a power of two");                          \
+                                                                                    \
+typedef struct {                                                                    \
+    type data[capacity];                                                            \
+    uint32_t head;  /* Next write position (free-running) */                        \
+    uint32_t tail;  /* Oldest element (free-running) */                             \
+} name##_t;                                                                         \
+                                                                                    \
+enum { name##_CAPACITY = (capacity), name##_MASK = (capacity) - 1 };                \
+                                                                                    \
+static inline void name##_init(name##_t *r) {                                       \
+    r->head = 0;                                                                    \
+    r->tail = 0;                                                                    \
+}                                                                                   \
+                                                                                    \
+static inline uint32_t name##_count(const name##_t *r) {                            \
+    return r->head - r->tail;                                                       \
+}                                                                                   \
+                                                                                    \
+static inline int name##_is_empty(const name##_t *r) {                              \
+    return r->head == r->tail;                                                      \
+}                                                                                   \
+                                                                                    \
+static inline int name##_is_full(const name##_t *r) {                               \
+    return r->head - r->tail == (capacity);                                         \
+}                                                                                   \
+                                                                                    \
+/* Returns 1 if stored, 0 if rejected (RING_REJECT and full) */                     \
+static inline int name##_push(name##_t *r, type item) {                             \
+    if (name##_is_full(r)) {                                                        \
+        if ((policy) == RING_REJECT) return 0;                                      \
+        r->tail++;                                                                  \
+    }                                                                               \
+    r->data[r->head & name##_MASK] = item;                                          \
+    r->head++;                                                                      \
+    return 1;                                                                       \
+}                                                                                   \
+                                                                                    \
+/* Returns 1 and writes *out if an element was available, 0 if empty */            \
+static inline int name##_pop(name##_t *r, type *out) {                              \
+    if (name##_is_empty(r)) return 0;                                               \
+    *out = r->data[r->tail & name##_MASK];                                          \
+    r->tail++;                                                                      \
+    return 1;                                                                       \
+}                                                                                   \
+                                                                                    \
+/* Copies n elements starting at logical position pos, in at most two memcpy */    \
+static inline void name##_copy_out(const name##_t *r, uint32_t pos,                 \
+                                   type *out, uint32_t n) {                         \
+    uint32_t start = pos & name##_MASK;                                             \
+    uint32_t first = (capacity) - start;                                            \
+    if (first > n) first = n;                                                       \
+    memcpy(out, &r->data[start], first * sizeof(type));                             \
+    memcpy(out + first, &r->data[0], (n - first) * sizeof(type));                   \
+}                                                                                   \
+                                                                                    \
+/* Pushes up to n elements; returns how many were stored.                          \
+ * RING_OVERWRITE keeps the newest `capacity` elements. */                          \
+static inline uint32_t name##_push_bulk(name##_t *r, const type *items,             \
+                                        uint32_t n) {                               \
+    uint32_t free_slots = (capacity) - name##_count(r);                             \
+    if ((policy) == RING_REJECT) {                                                  \
+        if (n > free_slots) n = free_slots;                                         \
+    } else {                                                                        \
+        if (n > (capacity)) {                                                       \
+            items += n - (capacity);                                                \
+            n = (capacity);                                                         \
+        }                                                                           \
+        if (n > free_slots) r->tail += n - free_slots;                              \
+    }                                                                               \
+    uint32_t start = r->head & name##_MASK;                                         \
+    uint32_t first = (capacity) - start;                                            \
+    if (first > n) first = n;                                                       \
+    memcpy(&r->data[start], items, first * sizeof(type));                           \
+    memcpy(&r->data[0], items + first, (n - first) * sizeof(type));                 \
+    r->head += n;                                                                   \
+    return n;                                                                       \
+}                                                                                   \
+                                                                                    \
+/* Copies up to n oldest elements without removing them; returns count copied */   \
+static inline uint32_t name##_peek_bulk(const name##_t *r, type *out, uint32_t n) { \
+    uint32_t count = name##_count(r);                                               \
+    if (n > count) n = count;                                                       \
+    name##_copy_out(r, r->tail, out, n);                                            \
+    return n;                                                                       \
+}                                                                                   \
+                                                                                    \
+/* Removes up to n oldest elements into out; returns count removed */              \
+static inline uint32_t name##_pop_bulk(name##_t *r, type *out, uint32_t n) {        \
+    n = name##_peek_bulk(r, out, n);                                                \
+    r->tail += n;                                                                   \
+    return n;                                                                       \
+}                                                                                   \
+                                                                                    \
+/* Drops up to n oldest elements (e.g. after a successful peek + send) */           \
+static inline uint32_t name##_discard(name##_t *r, uint32_t n) {                    \
+    uint32_t count = name##_count(r);                                               \
+    if (n > count) n = count;                                                       \
+    r->tail += n;                                                                   \
+    return n;                                                                       \
+}
+
+#endif // RING_H
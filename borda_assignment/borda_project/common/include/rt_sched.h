@@ -0,0 +1,46 @@
+#ifndef RT_SCHED_H
+#define RT_SCHED_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#define RT_DEFAULT_PRIORITY   80        // SCHED_FIFO priority for the sampling thread
+#define RT_PREFAULT_STACK     (64 * 1024) // Stack bytes touched before locking memory
+#define RT_HIST_BUCKETS       1000      // 1 µs buckets → 0..999 µs, rest goes to overflow
+
+// Opt-in real-time settings for a single thread
+typedef struct {
+    int enabled;   // 0 = ordinary SCHED_OTHER thread
+    int priority;  // SCHED_FIFO priority (1..99)
+    int cpu;       // CPU to pin to, -1 = no affinity change
+} rt_config_t;
+
+// cyclictest-style wake-up latency / jitter recorder
+typedef struct {
+    uint64_t samples;
+    int64_t  min_ns;
+    int64_t  max_ns;
+    int64_t  sum_ns;
+    int64_t  last_ns;                     // Previous latency, for jitter
+    int64_t  max_jitter_ns;
+    uint32_t latency_hist[RT_HIST_BUCKETS];
+    uint32_t jitter_hist[RT_HIST_BUCKETS];
+    uint32_t latency_overflow;
+    uint32_t jitter_overflow;
+} rt_latency_t;
+
+int  rt_lock_memory(size_t prefault_stack_bytes);
+int  rt_apply_thread(pthread_t thread, const rt_config_t *cfg);
+
+void rt_timespec_add_ns(struct timespec *ts, int64_t ns);
+int64_t rt_timespec_diff_ns(const struct timespec *a, const struct timespec *b);
+int  rt_sleep_until(const struct timespec *deadline);
+
+void rt_latency_init(rt_latency_t *lat);
+void rt_latency_record(rt_latency_t *lat, const struct timespec *deadline, const struct timespec *woke);
+void rt_latency_print(const rt_latency_t *lat, const char *label);
+int  rt_latency_write_histogram(const rt_latency_t *lat, const char *path);
+
+#endif // RT_SCHED_H
@@ -0,0 +1,43 @@
+#ifndef SIGNAL_MODEL_H
+#define SIGNAL_MODEL_H
+
+#include <stdint.h>
+#include "prng.h"
+
+// Parameters of a simulated sensor signal
+typedef struct {
+    float base;              // Mean level
+    float diurnal_amp;       // Amplitude of the daily sinusoid
+    float diurnal_period_s;  // Period of the sinusoid (86400 s = one day)
+    float noise_std;         // Gaussian measurement noise
+    float spike_prob;        // Per-sample probability of an outlier
+    float spike_amp;         // Outlier magnitude (sign is random)
+    float stuck_prob;        // Per-sample probability of a stuck-at fault starting
+    uint32_t stuck_len;      // Samples a stuck-at fault lasts
+    float step_prob;         // Per-sample probability of a step change
+    float step_amp;          // Step magnitude (sign is random)
+    float min, max;          // Physical range, output is clamped to it
+    float dt_s;              // Simulated time between samples
+} signal_cfg_t;
+
+// Per-channel simulator state; each instance owns its own PRNG
+typedef struct {
+    signal_cfg_t cfg;
+    prng_t rng;
+    double t;                // Simulated time (s)
+    float step_offset;       // Sum of all step changes so far
+    float stuck_value;
+    uint32_t stuck_left;
+} signal_model_t;
+
+// Default models for the simulated channels
+extern const signal_cfg_t SIGNAL_CFG_TEMPERATURE;
+extern const signal_cfg_t SIGNAL_CFG_HUMIDITY;
+extern const signal_cfg_t SIGNAL_CFG_PRESSURE;
+extern const signal_cfg_t SIGNAL_CFG_CO2;
+extern const signal_cfg_t SIGNAL_CFG_LIGHT;
+
+void  signal_model_init(signal_model_t *m, const signal_cfg_t *cfg, uint64_t seed);
+float signal_model_next(signal_model_t *m);
+
+#endif // SIGNAL_MODEL_H
@@ -0,0 +1,132 @@
+#include "persist.h"
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Table-driven CRC-32 (IEEE 802.3, reflected).
+ */
+static uint32_t crc32(const void *buf, size_t len) {
+    static uint32_t table[256];
+    static int ready = 0;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        ready = 1;
+    }
+
+    const uint8_t *p = buf;
+    uint32_t crc = 0xFFFFFFFFu;
+    while (len--) {
+        crc = table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Checks the header and data block of an existing state file.
+ * @return NULL if the state can be resumed, otherwise the reason it cannot
+ */
+static const char *validate(const persist_t *p, uint32_t version, size_t data_size,
+                            double max_age_s, double now) {
+    const persist_header_t *h = p->hdr;
+    if (h->magic != PERSIST_MAGIC) return "no previous state";
+    if (h->version != version || h->data_size != data_size) return "layout version changed";
+    if (crc32(p->data, data_size) != h->checksum) return "checksum mismatch (interrupted write)";
+    if (now - h->saved_at > max_age_s || now < h->saved_at) return "state too old";
+    return NULL;
+}
+
+/**
+ * @brief Maps the state file, creating or resizing it as needed, and decides
+ *        whether its contents can be resumed.
+ *
+ * The caller keeps its live state directly in p->data, so every sample updates
+ * the file in place (MAP_SHARED). persist_commit() then seals a consistent
+ * snapshot with a checksum and timestamp. A process crash between commits is
+ * detected on the next start by the checksum and the state is discarded.
+ *
+ * @param p         Handle to fill
+ * @param path      State file path
+ * @param version   Caller's layout version; bump it whenever the struct changes
+ * @param data_size sizeof the caller's state struct
+ * @param max_age_s Older snapshots are discarded instead of resumed
+ * @param now       Current CLOCK_REALTIME seconds
+ * @return PERSIST_RESTORED, PERSIST_FRESH (data zeroed, see p->reason) or PERSIST_FAILED
+ */
+persist_status_t persist_open(persist_t *p, const char *path, uint32_t version,
+                              size_t data_size, double max_age_s, double now) {
+    memset(p, 0, sizeof(*p));
+    p->fd = -1;
+    p->map_size = sizeof(persist_header_t) + data_size;
+
+    p->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (p->fd < 0) return PERSIST_FAILED;
+
+    struct stat st;
+    if (fstat(p->fd, &st) != 0) goto fail;
+    int resized = (size_t)st.st_size != p->map_size;
+    if (resized && ftruncate(p->fd, (off_t)p->map_size) != 0) goto fail;
+
+    void *map = mmap(NULL, p->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, p->fd, 0);
+    if (map == MAP_FAILED) goto fail;
+    p->hdr = map;
+    p->data = (uint8_t *)map + sizeof(persist_header_t);
+
+    p->reason = resized ? (st.st_size == 0 ? "no previous state" : "layout version changed")
+                        : validate(p, version, data_size, max_age_s, now);
+    if (p->reason == NULL) {
+        return PERSIST_RESTORED;
+    }
+
+    // Start over: clear the data and stamp a fresh header
+    memset(p->data, 0, data_size);
+    p->hdr->magic = PERSIST_MAGIC;
+    p->hdr->version = version;
+    p->hdr->data_size = data_size;
+    p->hdr->commits = 0;
+    persist_commit(p, now);
+    return PERSIST_FRESH;
+
+fail:
+    close(p->fd);
+    p->fd = -1;
+    return PERSIST_FAILED;
+}
+
+/**
+ * @brief Seals the current in-place state as a valid snapshot. Call once per
+ *        loop iteration, after all updates of that iteration.
+ *        The data already lives in the page cache; MS_ASYNC only schedules
+ *        writeback, so the loop never blocks on storage.
+ */
+void persist_commit(persist_t *p, double now) {
+    if (p->hdr == NULL) return;
+
+    p->hdr->checksum = crc32(p->data, p->hdr->data_size);
+    p->hdr->saved_at = now;
+    p->hdr->commits++;
+    msync(p->hdr, p->map_size, MS_ASYNC);
+}
+
+/**
+ * @brief Unmaps and closes the state file (the file itself is kept).
+ */
+void persist_close(persist_t *p) {
+    if (p->hdr != NULL) {
+        munmap(p->hdr, p->map_size);
+        p->hdr = NULL;
+        p->data = NULL;
+    }
+    if (p->fd >= 0) {
+        close(p->fd);
+        p->fd = -1;
+    }
+}
@@ -0,0 +1,184 @@
+#define _GNU_SOURCE  // for CPU_SET / pthread_setaffinity_np
+#include "rt_sched.h"
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define NSEC_PER_SEC 1000000000LL
+
+/**
+ * @brief Locks all current and future pages into RAM and prefaults the stack.
+ *        After this call, page faults can no longer delay the sampling loop.
+ *        Buffers should be allocated before calling it so they are locked as well.
+ * @param prefault_stack_bytes Number of stack bytes to touch (e.g. RT_PREFAULT_STACK)
+ * @return 0 on success, -1 on failure (errno set by mlockall)
+ */
+int rt_lock_memory(size_t prefault_stack_bytes) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        perror("mlockall");
+        return -1;
+    }
+
+    // Touch every stack page once so the kernel maps it now, not mid-loop
+    volatile unsigned char stack[prefault_stack_bytes];
+    for (size_t i = 0; i < prefault_stack_bytes; i += 4096) {
+        stack[i] = 0;
+    }
+    (void)stack[0];
+    return 0;
+}
+
+/**
+ * @brief Switches a thread to SCHED_FIFO with the given priority and pins it to a CPU.
+ *        Does nothing if cfg->enabled is 0. Needs root or CAP_SYS_NICE.
+ * @param thread Thread to configure (pthread_self() for the caller)
+ * @param cfg    Real-time settings
+ * @return 0 on success, -1 if either setting could not be applied
+ */
+int rt_apply_thread(pthread_t thread, const rt_config_t *cfg) {
+    if (!cfg->enabled) return 0;
+
+    int ret = 0;
+
+    if (cfg->cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cfg->cpu, &set);
+        int err = pthread_setaffinity_np(thread, sizeof(set), &set);
+        if (err != 0) {
+            fprintf(stderr, "pthread_setaffinity_np(cpu=%d): %s\n", cfg->cpu, strerror(err));
+            ret = -1;
+        }
+    }
+
+    struct sched_param param = { .sched_priority = cfg->priority };
+    int err = pthread_setschedparam(thread, SCHED_FIFO, &param);
+    if (err != 0) {
+        fprintf(stderr, "pthread_setschedparam(SCHED_FIFO, %d): %s\n", cfg->priority, strerror(err));
+        ret = -1;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Adds a (possibly negative) nanosecond offset to a timespec, keeping it normalized.
+ */
+void rt_timespec_add_ns(struct timespec *ts, int64_t ns) {
+    int64_t total = (int64_t)ts->tv_nsec + ns;
+    ts->tv_sec += total / NSEC_PER_SEC;
+    total %= NSEC_PER_SEC;
+    if (total < 0) {
+        total += NSEC_PER_SEC;
+        ts->tv_sec--;
+    }
+    ts->tv_nsec = (long)total;
+}
+
+/**
+ * @brief Returns a - b in nanoseconds.
+ */
+int64_t rt_timespec_diff_ns(const struct timespec *a, const struct timespec *b) {
+    return ((int64_t)a->tv_sec - b->tv_sec) * NSEC_PER_SEC + (a->tv_nsec - b->tv_nsec);
+}
+
+/**
+ * @brief Sleeps until an absolute CLOCK_MONOTONIC deadline.
+ *        Using absolute deadlines keeps the sampling period from drifting
+ *        by the time spent processing each sample.
+ * @param deadline Absolute wake-up time
+ * @return 0 when the deadline was reached, EINTR if interrupted by a signal
+ */
+int rt_sleep_until(const struct timespec *deadline) {
+    return clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL);
+}
+
+/**
+ * @brief Resets the latency recorder.
+ */
+void rt_latency_init(rt_latency_t *lat) {
+    memset(lat, 0, sizeof(*lat));
+    lat->min_ns = INT64_MAX;
+}
+
+/**
+ * @brief Records one wake-up: latency is how late the thread woke after its deadline,
+ *        jitter is the change in latency from the previous wake-up.
+ * @param lat      Recorder to update
+ * @param deadline Intended wake-up time
+ * @param woke     Actual wake-up time (CLOCK_MONOTONIC, read right after the sleep)
+ */
+void rt_latency_record(rt_latency_t *lat, const struct timespec *deadline, const struct timespec *woke) {
+    int64_t latency = rt_timespec_diff_ns(woke, deadline);
+    if (latency < 0) latency = 0;
+
+    if (latency < lat->min_ns) lat->min_ns = latency;
+    if (latency > lat->max_ns) lat->max_ns = latency;
+    lat->sum_ns += latency;
+
+    int64_t us = latency / 1000;
+    if (us < RT_HIST_BUCKETS) lat->latency_hist[us]++;
+    else                      lat->latency_overflow++;
+
+    // Jitter needs a previous sample to compare against
+    if (lat->samples > 0) {
+        int64_t jitter = latency - lat->last_ns;
+        if (jitter < 0) jitter = -jitter;
+        if (jitter > lat->max_jitter_ns) lat->max_jitter_ns = jitter;
+
+        int64_t jus = jitter / 1000;
+        if (jus < RT_HIST_BUCKETS) lat->jitter_hist[jus]++;
+        else                       lat->jitter_overflow++;
+    }
+
+    lat->last_ns = latency;
+    lat->samples++;
+}
+
+/**
+ * @brief Prints a one-line cyclictest-style latency summary.
+ * @param lat   Recorder to summarize
+ * @param label Thread name shown in the output
+ */
+void rt_latency_print(const rt_latency_t *lat, const char *label) {
+    if (lat->samples == 0) {
+        printf("⏱️  %s: no samples\n", label);
+        return;
+    }
+
+    printf("⏱️  %s: samples=%llu  Min=%lld us  Avg=%lld us  Max=%lld us  MaxJitter=%lld us  Overflow=%u\n",
+           label,
+           (unsigned long long)lat->samples,
+           (long long)(lat->min_ns / 1000),
+           (long long)(lat->sum_ns / (int64_t)lat->samples / 1000),
+           (long long)(lat->max_ns / 1000),
+           (long long)(lat->max_jitter_ns / 1000),
+           lat->latency_overflow);
+}
+
+/**
+ * @brief Writes latency and jitter histograms in cyclictest "-h" format:
+ *        one "<us> <latency_count> <jitter_count>" line per non-empty bucket,
+ *        followed by overflow counters. Suitable for gnuplot.
+ * @param lat  Recorder to dump
+ * @param path Output file path
+ * @return 0 on success, -1 on failure
+ */
+int rt_latency_write_histogram(const rt_latency_t *lat, const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+
+    fprintf(f, "# us latency jitter\n");
+    for (int i = 0; i < RT_HIST_BUCKETS; i++) {
+        if (lat->latency_hist[i] || lat->jitter_hist[i]) {
+            fprintf(f, "%d %u %u\n", i, lat->latency_hist[i], lat->jitter_hist[i]);
+        }
+    }
+    fprintf(f, "# Overflows: latency=%u jitter=%u\n", lat->latency_overflow, lat->jitter_overflow);
+    fprintf(f, "# Min/Max latency: %lld/%lld us\n",
+            (long long)(lat->samples ? lat->min_ns / 1000 : 0), (long long)(lat->max_ns / 1000));
+
+    fclose(f);
+    return 0;
+}
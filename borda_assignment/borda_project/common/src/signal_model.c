@@ -0,0 +1,90 @@
+#include "signal_model.h"
+#include <string.h> // for memset
+
+#define TWO_PI 6.28318530718
+#define DAY_S  86400.0f
+
+// Indoor temperature: 24 °C ± 2 °C daily swing, occasional spikes and faults
+const signal_cfg_t SIGNAL_CFG_TEMPERATURE = {
+    .base = 24.0f, .diurnal_amp = 2.0f, .diurnal_period_s = DAY_S, .noise_std = 0.05f,
+    .spike_prob = 0.01f, .spike_amp = 5.0f, .stuck_prob = 0.0005f, .stuck_len = 10,
+    .step_prob = 0.0005f, .step_amp = 1.0f, .min = -40.0f, .max = 85.0f, .dt_s = 1.0f
+};
+
+// Relative humidity moves opposite to temperature over the day
+const signal_cfg_t SIGNAL_CFG_HUMIDITY = {
+    .base = 55.0f, .diurnal_amp = -8.0f, .diurnal_period_s = DAY_S, .noise_std = 0.5f,
+    .spike_prob = 0.01f, .spike_amp = 15.0f, .stuck_prob = 0.0005f, .stuck_len = 10,
+    .step_prob = 0.0005f, .step_amp = 3.0f, .min = 0.0f, .max = 100.0f, .dt_s = 1.0f
+};
+
+const signal_cfg_t SIGNAL_CFG_PRESSURE = {
+    .base = 1013.0f, .diurnal_amp = 1.5f, .diurnal_period_s = DAY_S / 2, .noise_std = 0.2f,
+    .spike_prob = 0.005f, .spike_amp = 10.0f, .stuck_prob = 0.0f, .stuck_len = 0,
+    .step_prob = 0.0f, .step_amp = 0.0f, .min = 300.0f, .max = 1100.0f, .dt_s = 1.0f
+};
+
+// CO₂ rises during occupied hours; steps model windows opening/closing
+const signal_cfg_t SIGNAL_CFG_CO2 = {
+    .base = 600.0f, .diurnal_amp = 200.0f, .diurnal_period_s = DAY_S, .noise_std = 10.0f,
+    .spike_prob = 0.01f, .spike_amp = 400.0f, .stuck_prob = 0.0005f, .stuck_len = 20,
+    .step_prob = 0.001f, .step_amp = 150.0f, .min = 400.0f, .max = 5000.0f, .dt_s = 1.0f
+};
+
+const signal_cfg_t SIGNAL_CFG_LIGHT = {
+    .base = 400.0f, .diurnal_amp = 350.0f, .diurnal_period_s = DAY_S, .noise_std = 20.0f,
+    .spike_prob = 0.005f, .spike_amp = 500.0f, .stuck_prob = 0.0f, .stuck_len = 0,
+    .step_prob = 0.002f, .step_amp = 200.0f, .min = 0.0f, .max = 100000.0f, .dt_s = 1.0f
+};
+
+/**
+ * @brief Initializes a signal model with its own seeded PRNG.
+ * @param m    Model state
+ * @param cfg  Signal parameters (copied)
+ * @param seed Seed; the same seed reproduces the same signal
+ */
+void signal_model_init(signal_model_t *m, const signal_cfg_t *cfg, uint64_t seed) {
+    memset(m, 0, sizeof(*m));
+    m->cfg = *cfg;
+    prng_seed(&m->rng, seed);
+}
+
+/**
+ * @brief Produces the next sample and advances simulated time by cfg.dt_s.
+ *
+ * value = base + steps + diurnal sinusoid + Gaussian noise,
+ * then an optional spike is added, and during a stuck-at fault the value
+ * frozen at the start of the fault is returned instead.
+ *
+ * @param m Model state
+ * @return Simulated reading, clamped to [cfg.min, cfg.max]
+ */
+float signal_model_next(signal_model_t *m) {
+    const signal_cfg_t *c = &m->cfg;
+    m->t += c->dt_s;
+
+    if (c->step_prob > 0.0f && prng_uniform(&m->rng) < c->step_prob) {
+        m->step_offset += (prng_uniform(&m->rng) < 0.5f ? -c->step_amp : c->step_amp);
+    }
+
+    float phase = c->diurnal_period_s > 0.0f ? (float)(TWO_PI * m->t / c->diurnal_period_s) : 0.0f;
+    float value = c->base + m->step_offset
+                + c->diurnal_amp * sinf(phase)
+                + c->noise_std * prng_gaussian(&m->rng);
+
+    if (c->spike_prob > 0.0f && prng_uniform(&m->rng) < c->spike_prob) {
+        value += (prng_uniform(&m->rng) < 0.5f ? -c->spike_amp : c->spike_amp);
+    }
+
+    if (m->stuck_left > 0) {
+        m->stuck_left--;
+        value = m->stuck_value;
+    } else if (c->stuck_prob > 0.0f && prng_uniform(&m->rng) < c->stuck_prob) {
+        m->stuck_left = c->stuck_len;
+        m->stuck_value = value;
+    }
+
+    if (value < c->min) value = c->min;
+    if (value > c->max) value = c->max;
+    return value;
+}
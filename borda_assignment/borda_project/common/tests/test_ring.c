@@ -0,0 +1,143 @@
+#include <stdint.h>
+#include <stdio.h>
+#include "ring.h"
+
+// Small rings so every test wraps quickly
+RING_DEFINE(ow4, int, 4, RING_OVERWRITE)
+RING_DEFINE(rj4, int, 4, RING_REJECT)
+RING_DEFINE(ow1, int, 1, RING_OVERWRITE)
+RING_DEFINE(rj64, float, 64, RING_REJECT)
+
+static int failures = 0;
+
+#define CHECK(cond) do {                                                \
+        if (!(cond)) {                                                  \
+            printf("❌ %s:%d: %s\n", __FILE__, __LINE__, #cond);        \
+            failures++;                                                 \
+        }                                                               \
+    } while (0)
+
+/**
+ * @brief Push/pop across the end of the storage array, many times over.
+ */
+static void test_wraparound(void) {
+    rj4_t r;
+    rj4_init(&r);
+    int next_in = 0, next_out = 0, v;
+    for (int round = 0; round < 100; round++) {
+        // Alternate between 3 and 2 elements so the slot offset keeps moving
+        int n = round % 2 ? 2 : 3;
+        for (int i = 0; i < n; i++) CHECK(rj4_push(&r, next_in++) == 1);
+        for (int i = 0; i < n; i++) {
+            CHECK(rj4_pop(&r, &v) == 1);
+            CHECK(v == next_out++);
+        }
+        CHECK(rj4_is_empty(&r));
+    }
+    CHECK(rj4_pop(&r, &v) == 0);
+}
+
+/**
+ * @brief head/tail are free-running 32-bit counters; count and indexing must
+ *        survive their overflow.
+ */
+static void test_counter_overflow(void) {
+    ow4_t r;
+    ow4_init(&r);
+    r.head = r.tail = UINT32_MAX - 1;
+    for (int i = 0; i < 4; i++) CHECK(ow4_push(&r, i) == 1);
+    CHECK(ow4_count(&r) == 4 && ow4_is_full(&r));
+    CHECK(r.head < r.tail);   // head has wrapped past zero
+    int out[4];
+    CHECK(ow4_pop_bulk(&r, out, 4) == 4);
+    for (int i = 0; i < 4; i++) CHECK(out[i] == i);
+    CHECK(ow4_is_empty(&r));
+}
+
+/**
+ * @brief RING_OVERWRITE drops the oldest element when full; RING_REJECT refuses the new one.
+ */
+static void test_policies(void) {
+    ow4_t o;
+    ow4_init(&o);
+    for (int i = 0; i < 6; i++) CHECK(ow4_push(&o, i) == 1);
+    CHECK(ow4_count(&o) == 4);
+    int out[4];
+    CHECK(ow4_peek_bulk(&o, out, 4) == 4);
+    for (int i = 0; i < 4; i++) CHECK(out[i] == i + 2);
+
+    rj4_t r;
+    rj4_init(&r);
+    for (int i = 0; i < 4; i++) CHECK(rj4_push(&r, i) == 1);
+    CHECK(rj4_is_full(&r));
+    CHECK(rj4_push(&r, 99) == 0);
+    CHECK(rj4_peek_bulk(&r, out, 4) == 4);
+    for (int i = 0; i < 4; i++) CHECK(out[i] == i);
+
+    // Capacity 1 is the smallest power of two
+    ow1_t one;
+    ow1_init(&one);
+    ow1_push(&one, 7);
+    ow1_push(&one, 8);
+    int v;
+    CHECK(ow1_count(&one) == 1 && ow1_pop(&one, &v) == 1 && v == 8);
+}
+
+/**
+ * @brief Bulk push/peek/pop/discard at every starting offset, including
+ *        copies split across the end of the array.
+ */
+static void test_bulk(void) {
+    int in[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }, out[10];
+
+    for (int offset = 0; offset < 4; offset++) {
+        rj4_t r;
+        rj4_init(&r);
+        for (int i = 0; i < offset; i++) rj4_push(&r, -1);
+        CHECK(rj4_discard(&r, offset) == (uint32_t)offset);
+
+        // Reject: only the free slots are filled
+        CHECK(rj4_push_bulk(&r, in, 3) == 3);
+        CHECK(rj4_push_bulk(&r, in + 3, 3) == 1);
+        CHECK(rj4_pop_bulk(&r, out, 10) == 4);
+        for (int i = 0; i < 4; i++) CHECK(out[i] == i);
+
+        // Overwrite: more than capacity keeps the newest elements
+        ow4_t o;
+        ow4_init(&o);
+        for (int i = 0; i < offset; i++) ow4_push(&o, -1);
+        CHECK(ow4_push_bulk(&o, in, 10) == 4);
+        CHECK(ow4_peek_bulk(&o, out, 4) == 4);
+        for (int i = 0; i < 4; i++) CHECK(out[i] == 6 + i);
+        CHECK(ow4_push_bulk(&o, in, 2) == 2);
+        CHECK(ow4_pop_bulk(&o, out, 4) == 4);
+        CHECK(out[0] == 8 && out[1] == 9 && out[2] == 0 && out[3] == 1);
+    }
+
+    // Larger power of two with a split copy
+    rj64_t f;
+    rj64_init(&f);
+    float fin[64], fout[64];
+    for (int i = 0; i < 64; i++) fin[i] = (float)i;
+    CHECK(rj64_push_bulk(&f, fin, 50) == 50);
+    CHECK(rj64_discard(&f, 40) == 40);
+    CHECK(rj64_push_bulk(&f, fin, 64) == 54);
+    CHECK(rj64_count(&f) == 64);
+    CHECK(rj64_pop_bulk(&f, fout, 64) == 64);
+    for (int i = 0; i < 10; i++) CHECK(fout[i] == (float)(40 + i));
+    for (int i = 10; i < 64; i++) CHECK(fout[i] == (float)(i - 10));
+}
+
+int main(void) {
+    test_wraparound();
+    test_counter_overflow();
+    test_policies();
+    test_bulk();
+
+    if (failures) {
+        printf("❌ ring: %d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("✅ ring: all checks passed\n");
+    return 0;
+}
@@ -11,11 +11,15 @@ ADAPTER_IFACE = 'org.bluez.LEAdvertisingManager1'
 PAYLOAD_FILE = 'payload.bin'
 READ_INTERVAL_SEC = 30
 EXPECTED_PAYLOAD_LEN = 27  # Counter(1) + Timestamp(2) + 3 sensors * 4 stats * 2 bytes = 27
+TREND_PAYLOAD_LEN = 33     # env_sensor --trend: + 3 sensors * int16 slope per minute
+LEGACY_ADV_DATA_LEN = 31   # Legacy advertising data limit
+MANUF_AD_OVERHEAD = 4      # AD length(1) + AD type(1) + company ID(2)
 
 class Advertisement(dbus.service.Object):
-    def __init__(self, bus, index):
+    def __init__(self, bus, index, max_adv_len=LEGACY_ADV_DATA_LEN):
         self.bus = bus
         self.path = f"/org/bluez/example/advertisement{index}"
+        self.max_payload_len = max_adv_len - MANUF_AD_OVERHEAD
         self.payload = self.read_payload()
         super().__init__(bus, self.path)
 
@@ -26,13 +30,15 @@ class Advertisement(dbus.service.Object):
         """
         Reads the payload.bin file and parses 27-byte BLE data.
         Displays decoded statistics in the terminal for verification.
+        33-byte --trend payloads only fit in extended advertising; on
+        controllers without it the trend fields are dropped.
         """
         try:
             with open(PAYLOAD_FILE, "rb") as f:
                 data = f.read()
-                if len(data) != EXPECTED_PAYLOAD_LEN:
+                if len(data) not in (EXPECTED_PAYLOAD_LEN, TREND_PAYLOAD_LEN):
                     raise ValueError(
-                        f"Payload must be {EXPECTED_PAYLOAD_LEN} bytes! Got: {len(data)} bytes"
+                        f"Payload must be {EXPECTED_PAYLOAD_LEN} or {TREND_PAYLOAD_LEN} bytes! Got: {len(data)} bytes"
                     )
 
                 counter = data[0]
@@ -62,6 +68,16 @@ class Advertisement(dbus.service.Object):
                           f"Max={max_v/scale:.2f}, Min={min_v/scale:.2f}, "
                           f"Med={med/scale:.2f}")
 
+                    if len(data) == TREND_PAYLOAD_LEN:
+                        base = EXPECTED_PAYLOAD_LEN + i * 2
+                        slope = int.from_bytes(data[base:base+2], "little", signed=True)
+                        print(f"    Trend={slope/scale:+.2f}/min")
+
+                if len(data) > self.max_payload_len:
+                    print(f"⚠️ {len(data)}-byte payload exceeds the {self.max_payload_len}-byte "
+                          f"advertising limit (no extended advertising); sending without trend fields")
+                    data = data[:EXPECTED_PAYLOAD_LEN]
+
                 return list(data)
 
         except Exception as e:
@@ -87,11 +103,15 @@ class Advertisement(dbus.service.Object):
             dbus.UInt16(0xFFFF): dbus.Array(self.payload, signature='y')
         }, signature='qv')
 
-        return {
+        props = {
             'Type': dbus.String('peripheral'),
             'LocalName': dbus.String('RPi'),
             'ManufacturerData': manuf_data
         }
+        if len(self.payload) + MANUF_AD_OVERHEAD > LEGACY_ADV_DATA_LEN:
+            # Setting a secondary channel makes BlueZ use extended advertising
+            props['SecondaryChannel'] = dbus.String('1M')
+        return props
 
     @dbus.service.method('org.freedesktop.DBus.Introspectable',
                          in_signature='', out_signature='s')
@@ -102,6 +122,21 @@ class Advertisement(dbus.service.Object):
     def Release(self):
         print("🔕 Advertisement released")
 
+def query_max_adv_len(bus):
+    """
+    Returns the advertising data limit of the controller: the extended
+    advertising MaxAdvLen if BlueZ reports it, else the 31-byte legacy limit.
+    """
+    try:
+        props = dbus.Interface(bus.get_object(BLUEZ_SERVICE_NAME, '/org/bluez/hci0'),
+                               'org.freedesktop.DBus.Properties')
+        if not props.Get(ADAPTER_IFACE, 'SupportedSecondaryChannels'):
+            return LEGACY_ADV_DATA_LEN
+        caps = props.Get(ADAPTER_IFACE, 'SupportedCapabilities')
+        return int(caps.get('MaxAdvLen', LEGACY_ADV_DATA_LEN))
+    except dbus.exceptions.DBusException:
+        return LEGACY_ADV_DATA_LEN
+
 def register_advertisement(bus, adv):
     """
     Registers the BLE advertisement object with BlueZ.
@@ -122,7 +157,10 @@ def main():
     dbus.mainloop.glib.DBusGMainLoop(set_as_default=True)
     bus = dbus.SystemBus()
 
-    adv = Advertisement(bus, 0)
+    max_adv_len = query_max_adv_len(bus)
+    print(f"📏 Advertising data limit: {max_adv_len} bytes")
+
+    adv = Advertisement(bus, 0, max_adv_len)
     adapter = register_advertisement(bus, adv)
 
     loop = GLib.MainLoop()
@@ -0,0 +1,50 @@
+#ifndef ADAPTIVE_H
+#define ADAPTIVE_H
+
+#include <stdint.h>
+#include "ble_payload.h"
+
+#define BLE_FIELDS_PER_SENSOR 4          // std, max, min, median
+#define BLE_SENSOR_COUNT      3          // temp, hum, CO₂
+
+// Per-channel adaptive sampling thresholds
+typedef struct {
+    float min_period_s;   // Fastest sampling period (signal active)
+    float max_period_s;   // Slowest sampling period (signal stable)
+    float stable_rate;    // |dx/dt| below this (and low variance) → stretch period
+    float active_rate;    // |dx/dt| above this → snap back to min_period_s
+    float active_var;     // Smoothed variance above this → snap back to min_period_s
+} adaptive_cfg_t;
+
+// Per-channel adaptive sampling state
+typedef struct {
+    adaptive_cfg_t cfg;
+    float period_s;       // Current sampling period
+    double next_due;      // Monotonic time (s) of the next read
+    double last_time;
+    float last_value;
+    float ewma_mean;
+    float ewma_var;
+    uint8_t has_last;
+} adaptive_channel_t;
+
+// Send-on-delta gate for BLE payloads
+typedef struct {
+    uint16_t field_delta[BLE_SENSOR_COUNT]; // Min change (encoded units) per sensor to publish
+    float heartbeat_s;                      // Publish anyway after this long
+    uint8_t last_sent[BLE_PAYLOAD_SIZE];
+    double last_sent_time;
+    uint8_t has_sent;
+    uint32_t evaluated;                     // Candidate payloads checked
+    uint32_t published;                     // Payloads actually published
+} send_on_delta_t;
+
+void adaptive_init(adaptive_channel_t *ch, const adaptive_cfg_t *cfg, double now);
+int  adaptive_due(const adaptive_channel_t *ch, double now);
+void adaptive_update(adaptive_channel_t *ch, float value, double now);
+
+void sod_init(send_on_delta_t *g, const uint16_t field_delta[BLE_SENSOR_COUNT], float heartbeat_s);
+int  sod_should_publish(send_on_delta_t *g, const uint8_t *payload, double now);
+void sod_mark_published(send_on_delta_t *g, const uint8_t *payload, double now);
+
+#endif // ADAPTIVE_H
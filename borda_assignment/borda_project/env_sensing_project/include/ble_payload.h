@@ -2,13 +2,43 @@
 #define BLE_PAYLOAD_H
 
 #include <stdint.h>
+#include <time.h>
 #include "stats.h"
 
 #define BLE_PAYLOAD_SIZE 27  // 1 (counter) + 2 (zaman) + 3*(4 istatistik*2 bayt)
+#define BLE_TREND_FIELDS_SIZE 6                                       // 3 × int16 slope
+#define BLE_PAYLOAD_TREND_SIZE (BLE_PAYLOAD_SIZE + BLE_TREND_FIELDS_SIZE) // Needs extended advertising
+
+// Largest ManufacturerData payload in a 31-byte legacy advertisement:
+// 31 - AD length(1) - AD type(1) - company ID(2)
+#define BLE_LEGACY_PAYLOAD_MAX 27
+
+_Static_assert(BLE_PAYLOAD_SIZE <= BLE_LEGACY_PAYLOAD_MAX,
+               "Default payload must fit in legacy advertising");
 
 void encode_ble_advertising_data(uint8_t *payload,
                                  const stats_t *temp_stats,
                                  const stats_t *hum_stats,
                                  const stats_t *co2_stats);
 
+// Split encoder: fill the statistics fields first, stamp counter/timestamp only when publishing
+void encode_ble_stats_fields(uint8_t *payload,
+                             const stats_t *temp_stats,
+                             const stats_t *hum_stats,
+                             const stats_t *co2_stats);
+void encode_ble_header(uint8_t *payload);
+
+// Encoder state (rolling counter), for callers that persist it or run several encoders
+typedef struct {
+    uint8_t counter;
+} ble_encoder_t;
+
+void ble_encoder_header(ble_encoder_t *enc, uint8_t *payload, time_t now);
+
+// Optional trend fields (bytes 27-32), for payloads of BLE_PAYLOAD_TREND_SIZE
+void encode_ble_trend_fields(uint8_t *payload,
+                             const stats_t *temp_stats,
+                             const stats_t *hum_stats,
+                             const stats_t *co2_stats);
+
 #endif
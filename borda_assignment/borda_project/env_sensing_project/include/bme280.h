@@ -2,18 +2,25 @@
 #define BME280_H
 
 #include <stdint.h>
+#include "bme280_compensate.h"
 
 #define BME280_ADDR 0x76
 #define BME280_REG_ID 0xD0
+#define BME280_REG_DATA 0xF7   // press_msb..hum_lsb
+#define BME280_DATA_LEN 8
 
 int bme280_read_chip_id(int fd, uint8_t *chip_id);
 int bme280_configure(int fd);
 int bme280_read_raw_temp(int fd, int32_t *raw_temp);
 int bme280_read_calibration(int fd, uint16_t *T1, int16_t *T2, int16_t *T3);
 float bme280_calibrate_temp(int32_t raw_temp, uint16_t T1, int16_t T2, int16_t T3);
+int bme280_read_calibration_full(int fd, bme280_calib_t *calib);
+int bme280_read_raw(int fd, bme280_raw_t *raw);
+void bme280_parse_raw(const uint8_t data[BME280_DATA_LEN], bme280_raw_t *raw);
 float bme280_read_temperature(void); // opsiyonel — eğer simüle ediyorsan
 float bme280_read_humidity(void);    // simülasyon
 float bme280_read_pressure(void);    // simülasyon
+void bme280_sim_seed(uint64_t seed); // simülasyon tohumu (tekrarlanabilir çalıştırma)
 
 
 #endif // BME280_H
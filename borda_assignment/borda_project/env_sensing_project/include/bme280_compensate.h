@@ -0,0 +1,56 @@
+#ifndef BME280_COMPENSATE_H
+#define BME280_COMPENSATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Factory trimming parameters (registers 0x88..0xA1 and 0xE1..0xE7)
+typedef struct {
+    uint16_t T1;
+    int16_t  T2, T3;
+    uint16_t P1;
+    int16_t  P2, P3, P4, P5, P6, P7, P8, P9;
+    uint8_t  H1;
+    int16_t  H2;
+    uint8_t  H3;
+    int16_t  H4, H5;
+    int8_t   H6;
+} bme280_calib_t;
+
+// One raw ADC triple as read from 0xF7..0xFE
+typedef struct {
+    int32_t adc_T;   // 20 bit
+    int32_t adc_P;   // 20 bit
+    int32_t adc_H;   // 16 bit
+} bme280_raw_t;
+
+// Compensated reading in physical units
+typedef struct {
+    float temperature;   // °C
+    float pressure;      // hPa
+    float humidity;      // %RH
+} bme280_reading_t;
+
+#define BME280_CALIB_TP_LEN  26   // 0x88..0xA1
+#define BME280_CALIB_H_LEN   7    // 0xE1..0xE7
+
+void bme280_parse_calibration(const uint8_t tp[BME280_CALIB_TP_LEN],
+                              const uint8_t h[BME280_CALIB_H_LEN], bme280_calib_t *calib);
+
+// Datasheet fixed-point variants (section 4.2.3); t_fine comes from the temperature step
+int32_t  bme280_compensate_T_int32(int32_t adc_T, const bme280_calib_t *calib, int32_t *t_fine);
+uint32_t bme280_compensate_P_int64(int32_t adc_P, const bme280_calib_t *calib, int32_t t_fine);
+uint32_t bme280_compensate_H_int32(int32_t adc_H, const bme280_calib_t *calib, int32_t t_fine);
+
+// Datasheet floating-point variants (section 8.1)
+double bme280_compensate_T_double(int32_t adc_T, const bme280_calib_t *calib, int32_t *t_fine);
+double bme280_compensate_P_double(int32_t adc_P, const bme280_calib_t *calib, int32_t t_fine);
+double bme280_compensate_H_double(int32_t adc_H, const bme280_calib_t *calib, int32_t t_fine);
+
+void bme280_compensate(const bme280_raw_t *raw, const bme280_calib_t *calib, bme280_reading_t *out);
+
+void bme280_compensate_batch(const bme280_calib_t *calib,
+                             const int32_t *adc_T, const int32_t *adc_P, const int32_t *adc_H,
+                             float *temperature, float *pressure, float *humidity, size_t n);
+
+#endif // BME280_COMPENSATE_H
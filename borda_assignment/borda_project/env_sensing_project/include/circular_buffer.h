@@ -2,14 +2,14 @@
 #define CIRCULAR_BUFFER_H
 
 #include <stdint.h>
+#include "ring.h"
 
-#define BUFFER_SIZE 50
+#define BUFFER_SIZE 64  // Power of two for mask indexing (was 50)
 
-typedef struct {
-    float data[BUFFER_SIZE];
-    uint8_t head;
-    uint8_t count;
-} circular_buffer_t;
+// Float ring for filtered samples: the oldest value is overwritten when full
+RING_DEFINE(float_ring, float, BUFFER_SIZE, RING_OVERWRITE)
+
+typedef float_ring_t circular_buffer_t;
 
 void cb_init(circular_buffer_t *cb);
 void cb_push(circular_buffer_t *cb, float value);
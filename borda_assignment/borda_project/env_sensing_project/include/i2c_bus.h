@@ -0,0 +1,57 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "ring.h"
+
+#define I2C_BUS_MAX_READ    32    // Bytes per read request
+#define I2C_BUS_QUEUE_SIZE  64    // Submit and completion queue depth (power of two)
+#define I2C_BUS_MAX_BATCH   21    // Reads per I2C_RDWR (2 messages each, kernel limit is 42)
+
+// One register read on any device of the bus
+typedef struct {
+    uint32_t tag;                  // Caller-defined, returned unchanged with the completion
+    uint8_t  addr;                 // 7-bit device address
+    uint8_t  reg;                  // Start register
+    uint8_t  len;                  // Bytes to read (1..I2C_BUS_MAX_READ)
+    int8_t   status;               // Completion: 0 = ok, -1 = transfer failed
+    uint8_t  data[I2C_BUS_MAX_READ];
+} i2c_request_t;
+
+RING_DEFINE(i2c_req_ring, i2c_request_t, I2C_BUS_QUEUE_SIZE, RING_REJECT)
+
+typedef struct {
+    int fd;
+    char path[32];
+    int running;                   // Worker keeps going; guarded by submit_lock
+    pthread_t thread;
+
+    // Caller → worker: requests wait here until i2c_bus_flush()
+    pthread_mutex_t submit_lock;
+    pthread_cond_t submit_cond;
+    i2c_req_ring_t submitted;
+    int flush_requested;
+
+    // Worker → caller
+    pthread_mutex_t done_lock;
+    pthread_cond_t done_cond;
+    i2c_req_ring_t completed;
+    int stopped;                   // Worker has exited; guarded by done_lock
+
+    int single_read;               // Adapter rejected a combined transfer (EOPNOTSUPP); worker only
+
+    // Counters (written by the worker only; final after i2c_bus_stop())
+    uint32_t transfers;            // I2C_RDWR ioctls issued
+    uint32_t requests;             // Reads carried by those ioctls
+    uint32_t failures;
+} i2c_bus_t;
+
+int  i2c_bus_start(i2c_bus_t *bus, const char *device_path);
+int  i2c_bus_submit(i2c_bus_t *bus, uint32_t tag, uint8_t addr, uint8_t reg, uint8_t len);
+void i2c_bus_flush(i2c_bus_t *bus);
+int  i2c_bus_wait(i2c_bus_t *bus, i2c_request_t *out);
+int  i2c_bus_poll(i2c_bus_t *bus, i2c_request_t *out);
+void i2c_bus_stop(i2c_bus_t *bus);
+
+#endif // I2C_BUS_H
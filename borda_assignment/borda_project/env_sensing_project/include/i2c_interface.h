@@ -12,6 +12,7 @@ typedef enum {
 } sensor_type_t;
 
 float i2c_sensor_read(uint8_t device_address, sensor_type_t type);
+void i2c_sim_seed(uint64_t seed);
 
 
 int i2c_open(const char *device_path);
@@ -4,8 +4,23 @@
 #include <stdint.h>
 
 #define MAX_WINDOW_SIZE 11  // Gerekirse büyütülebilir
+#define MF_BANK_LANES   16  // Max channels/nodes filtered together by a median bank
 
 // Medyan filtreleme fonksiyonu
 float apply_median_filter(float new_sample, float *buffer, uint8_t window_size, uint8_t *index, uint8_t *count);
 
+// Moving median over up to MF_BANK_LANES streams at once, stored SoA:
+// window[k][lane] is the k-th slot of that lane's circular buffer, so one
+// vector load fetches the same slot of 4 lanes.
+typedef struct {
+    float window[MAX_WINDOW_SIZE][MF_BANK_LANES] __attribute__((aligned(16)));
+    uint8_t size;    // Window size shared by all lanes
+    uint8_t lanes;   // Active lanes (1..MF_BANK_LANES)
+    uint8_t index;   // Next slot to write
+    uint8_t count;   // Samples per lane so far, up to size
+} median_bank_t;
+
+int median_bank_init(median_bank_t *bank, uint8_t window_size, uint8_t lanes);
+void median_bank_apply(median_bank_t *bank, const float *samples, float *out);
+
 #endif // MEDIAN_FILTER_H
@@ -0,0 +1,61 @@
+#ifndef QUANTILE_H
+#define QUANTILE_H
+
+#include <stdint.h>
+
+#define QSKETCH_COMPRESSION 40   // t-digest δ: accuracy vs. size trade-off
+#define QSKETCH_CAPACITY    48   // ≥ δ + 1 centroids always fit after compression
+#define QSKETCH_BUFFER      16   // Samples collected before a compression pass
+#define TW_PANES            12   // Sub-windows per time window
+#define TW_SLOTS            (TW_PANES + 1)  // + the partly filled current pane
+
+// Bounded-memory, mergeable quantile sketch (merging t-digest)
+typedef struct {
+    float mean[QSKETCH_CAPACITY];
+    float weight[QSKETCH_CAPACITY];
+    float buffer[QSKETCH_BUFFER];
+    uint8_t centroids;
+    uint8_t buffered;
+    float min;
+    float max;
+    uint32_t count;
+} qsketch_t;
+
+// One pane of a time window: sketch plus running moments
+typedef struct {
+    int64_t id;      // floor(time / pane length); -1 = unused
+    qsketch_t sketch;
+    double sum;
+    double sum_sq;
+} tw_pane_t;
+
+// Time-based sliding window (e.g. last 60 s / 15 min / 24 h), independent of sample rate
+typedef struct {
+    float window_s;
+    float pane_s;
+    tw_pane_t panes[TW_SLOTS];
+} time_window_t;
+
+// Statistics over a time window
+typedef struct {
+    uint32_t count;
+    float mean;
+    float std_dev;
+    float min;
+    float max;
+    float p5;
+    float p50;
+    float p95;
+    float p99;
+} window_stats_t;
+
+void  qsketch_init(qsketch_t *sk);
+void  qsketch_add(qsketch_t *sk, float value);
+void  qsketch_merge(qsketch_t *dst, const qsketch_t *src);
+float qsketch_quantile(qsketch_t *sk, float q);
+
+void tw_init(time_window_t *tw, float window_s);
+void tw_add(time_window_t *tw, float value, double now);
+void tw_query(const time_window_t *tw, double now, window_stats_t *out);
+
+#endif // QUANTILE_H
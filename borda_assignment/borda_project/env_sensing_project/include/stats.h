@@ -10,6 +10,13 @@ typedef struct {
     float mean;
     float std_dev;
     float median;
+
+    // Trend over the sliding window (filled by trend_fill_stats(), 0 otherwise)
+    float slope;        // Least-squares slope, units per minute
+    float intercept;    // Fitted value at the newest sample
+    float r2;           // Fit quality, 0..1
+    float holt_level;   // Holt smoothed level (--holt)
+    float holt_slope;   // Holt smoothed trend, units per minute (--holt)
 } stats_t;
 
 // Hesaplama fonksiyonu
@@ -0,0 +1,80 @@
+#ifndef STREAM_SERVER_H
+#define STREAM_SERVER_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "ring.h"
+
+#define STREAM_DEFAULT_PATH     "/tmp/env_sensor.sock"
+#define STREAM_MAGIC            0x534E5645u  // "EVNS" little-endian
+#define STREAM_MAX_SUBSCRIBERS  8
+#define STREAM_MAX_CHANNELS     8            // Channel ids 0..7 (bit in channel_mask)
+#define STREAM_MAX_BATCH        64           // Samples per frame
+#define STREAM_FLUSH_MS         100          // Partial batches are sent after this long
+#define STREAM_INGRESS_SIZE     1024         // Acquisition → server thread ring
+#define STREAM_QUEUE_SIZE       256          // Per-subscriber ring
+
+// What to do when a subscriber's queue is full
+typedef enum {
+    STREAM_DROP_OLDEST = 0,   // Keep the freshest data (default)
+    STREAM_DROP_NEWEST = 1,   // Keep the backlog, discard new samples
+    STREAM_DISCONNECT  = 2    // Close the connection
+} stream_policy_t;
+
+// One sample on the wire
+typedef struct {
+    int64_t  timestamp_us;    // CLOCK_REALTIME, microseconds
+    uint32_t seq;             // Per-channel sample counter (before decimation)
+    uint8_t  channel;
+    uint8_t  reserved[3];
+    float    value;
+    uint32_t reserved2;
+} stream_sample_t;
+
+// Client → server, sent once right after connecting
+typedef struct {
+    uint32_t magic;           // STREAM_MAGIC
+    uint8_t  channel_mask;    // Bit i set → receive channel i
+    uint8_t  policy;          // stream_policy_t
+    uint16_t decimation;      // Deliver every Nth sample per channel (0/1 = all)
+} stream_subscribe_t;
+
+// Server → client frame header, followed by `count` stream_sample_t
+typedef struct {
+    uint32_t magic;           // STREAM_MAGIC
+    uint16_t count;
+    uint16_t reserved;
+    uint32_t dropped;         // Samples dropped for this subscriber since the last frame
+    uint32_t reserved2;
+} stream_frame_header_t;
+
+RING_DEFINE(stream_ring, stream_sample_t, STREAM_QUEUE_SIZE, RING_REJECT)
+RING_DEFINE(stream_ingress, stream_sample_t, STREAM_INGRESS_SIZE, RING_OVERWRITE)
+
+typedef struct {
+    int fd;                   // -1 = slot free
+    int subscribed;           // Subscribe message received
+    stream_subscribe_t sub;
+    uint32_t decim_count[STREAM_MAX_CHANNELS];
+    uint32_t dropped;
+    double last_flush;        // Monotonic time of the last frame sent
+    stream_ring_t queue;
+} stream_subscriber_t;
+
+typedef struct {
+    int listen_fd;
+    int wake_fd;              // eventfd: publish/stop → server thread
+    char path[108];
+    volatile int running;
+    pthread_t thread;
+    pthread_mutex_t ingress_lock;
+    stream_ingress_t ingress;
+    uint32_t seq[STREAM_MAX_CHANNELS];
+    stream_subscriber_t subs[STREAM_MAX_SUBSCRIBERS];
+} stream_server_t;
+
+int  stream_server_start(stream_server_t *srv, const char *path);
+void stream_server_publish(stream_server_t *srv, uint8_t channel, float value, int64_t timestamp_us);
+void stream_server_stop(stream_server_t *srv);
+
+#endif // STREAM_SERVER_H
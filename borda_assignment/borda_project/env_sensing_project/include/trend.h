@@ -0,0 +1,42 @@
+#ifndef TREND_H
+#define TREND_H
+
+#include <stdint.h>
+#include "stats.h"
+
+#define TREND_WINDOW 64          // Samples in the regression window (power of two)
+
+// Sliding least-squares fit over the last TREND_WINDOW samples, plus optional
+// Holt double-exponential smoothing. Every update is O(1).
+typedef struct {
+    // Regression: running sums over (x, y), x = seconds since `origin`
+    double x[TREND_WINDOW];
+    double y[TREND_WINDOW];
+    uint32_t head;               // Next slot to write
+    uint32_t count;
+    double origin;               // Rebased every TREND_WINDOW samples to keep x small
+    double sx, sy, sxx, sxy, syy;
+
+    // Holt (disabled when alpha == 0)
+    float alpha;                 // Level smoothing
+    float beta;                  // Trend smoothing
+    double level;
+    double holt_slope;           // Units per second
+    double last_time;
+    uint8_t holt_started;
+} trend_t;
+
+typedef struct {
+    float slope;                 // Units per second
+    float intercept;             // Fitted value at the newest sample
+    float r2;                    // Coefficient of determination (0..1)
+    uint32_t n;                  // Samples in the fit
+} trend_fit_t;
+
+void trend_init(trend_t *t, float alpha, float beta);
+void trend_add(trend_t *t, float value, double now);
+void trend_fit(const trend_t *t, trend_fit_t *out);
+float trend_holt_forecast(const trend_t *t, float horizon_s);
+void trend_fill_stats(const trend_t *t, stats_t *s);
+
+#endif // TREND_H
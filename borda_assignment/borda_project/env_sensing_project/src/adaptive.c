@@ -0,0 +1,118 @@
+#include "adaptive.h"
+#include <math.h>   // for fabsf
+#include <string.h> // for memcpy
+
+#define EWMA_ALPHA 0.2f      // Smoothing factor for mean/variance tracking
+#define STRETCH_FACTOR 2.0f  // Period multiplier while the signal is stable
+
+/**
+ * @brief Initializes an adaptive sampling channel at its fastest period.
+ * @param ch  Channel state to initialize
+ * @param cfg Thresholds and period limits for this channel
+ * @param now Current monotonic time in seconds (first read is due immediately)
+ */
+void adaptive_init(adaptive_channel_t *ch, const adaptive_cfg_t *cfg, double now) {
+    memset(ch, 0, sizeof(*ch));
+    ch->cfg = *cfg;
+    ch->period_s = cfg->min_period_s;
+    ch->next_due = now;
+}
+
+/**
+ * @brief Checks whether the channel should be read at this tick.
+ * @return 1 if a read is due, 0 otherwise
+ */
+int adaptive_due(const adaptive_channel_t *ch, double now) {
+    // Small tolerance so a read due "exactly now" is not pushed to the next tick
+    return now + 1e-3 >= ch->next_due;
+}
+
+/**
+ * @brief Feeds a new reading and adjusts the sampling period.
+ *
+ * The rate of change is measured against the previous reading, and the
+ * variance is tracked with an exponentially weighted moving average.
+ * - Active signal (rate or variance above threshold): snap back to min period
+ * - Stable signal (rate below stable_rate, variance low): stretch period ×2
+ * - In between: keep the current period
+ *
+ * @param ch    Channel state
+ * @param value New reading
+ * @param now   Monotonic time of the reading in seconds
+ */
+void adaptive_update(adaptive_channel_t *ch, float value, double now) {
+    if (!ch->has_last) {
+        ch->ewma_mean = value;
+        ch->ewma_var = 0.0f;
+    } else {
+        float dt = (float)(now - ch->last_time);
+        float rate = dt > 0.0f ? fabsf(value - ch->last_value) / dt : 0.0f;
+
+        float diff = value - ch->ewma_mean;
+        ch->ewma_mean += EWMA_ALPHA * diff;
+        ch->ewma_var = (1.0f - EWMA_ALPHA) * (ch->ewma_var + EWMA_ALPHA * diff * diff);
+
+        if (rate > ch->cfg.active_rate || ch->ewma_var > ch->cfg.active_var) {
+            ch->period_s = ch->cfg.min_period_s;
+        } else if (rate < ch->cfg.stable_rate && ch->ewma_var < ch->cfg.active_var / 4.0f) {
+            ch->period_s *= STRETCH_FACTOR;
+            if (ch->period_s > ch->cfg.max_period_s)
+                ch->period_s = ch->cfg.max_period_s;
+        }
+    }
+
+    ch->last_value = value;
+    ch->last_time = now;
+    ch->has_last = 1;
+    ch->next_due = now + ch->period_s;
+}
+
+/**
+ * @brief Initializes the send-on-delta payload gate.
+ * @param g           Gate state
+ * @param field_delta Per-sensor minimum change in encoded units (e.g. 10 = 0.10 °C for temperature)
+ * @param heartbeat_s Maximum time between published payloads
+ */
+void sod_init(send_on_delta_t *g, const uint16_t field_delta[BLE_SENSOR_COUNT], float heartbeat_s) {
+    memset(g, 0, sizeof(*g));
+    memcpy(g->field_delta, field_delta, sizeof(g->field_delta));
+    g->heartbeat_s = heartbeat_s;
+}
+
+/**
+ * @brief Decides whether a candidate payload is worth publishing.
+ *        Only the statistics fields (bytes 3-26) are compared; the counter and
+ *        timestamp header always change and are ignored.
+ * @param g       Gate state
+ * @param payload Candidate payload (BLE_PAYLOAD_SIZE bytes)
+ * @param now     Monotonic time in seconds
+ * @return 1 if any field moved by more than its delta or the heartbeat expired
+ */
+int sod_should_publish(send_on_delta_t *g, const uint8_t *payload, double now) {
+    g->evaluated++;
+
+    if (!g->has_sent || now - g->last_sent_time >= g->heartbeat_s)
+        return 1;
+
+    for (int s = 0; s < BLE_SENSOR_COUNT; s++) {
+        for (int f = 0; f < BLE_FIELDS_PER_SENSOR; f++) {
+            int offset = 3 + s * 8 + f * 2;
+            int cur  = payload[offset]     | (payload[offset + 1] << 8);
+            int prev = g->last_sent[offset] | (g->last_sent[offset + 1] << 8);
+            int diff = cur > prev ? cur - prev : prev - cur;
+            if (diff > g->field_delta[s])
+                return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Records a payload as published, making it the new reference for deltas.
+ */
+void sod_mark_published(send_on_delta_t *g, const uint8_t *payload, double now) {
+    memcpy(g->last_sent, payload, BLE_PAYLOAD_SIZE);
+    g->last_sent_time = now;
+    g->has_sent = 1;
+    g->published++;
+}
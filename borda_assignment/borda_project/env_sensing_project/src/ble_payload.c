@@ -1,5 +1,4 @@
 #include "ble_payload.h"
-#include <time.h>
 
 /**
  * @brief Encodes environmental sensor statistics into a BLE advertising payload.
@@ -21,16 +20,47 @@ void encode_ble_advertising_data(uint8_t *payload,
                                  const stats_t *temp_stats,
                                  const stats_t *hum_stats,
                                  const stats_t *co2_stats) {
-    static uint8_t counter = 0;
+    encode_ble_header(payload);
+    encode_ble_stats_fields(payload, temp_stats, hum_stats, co2_stats);
+}
 
+/**
+ * @brief Writes the rolling counter and truncated timestamp (bytes 0-2).
+ *        Each call consumes one counter value, so call it only for payloads
+ *        that are actually published.
+ * @param payload Pointer to the payload buffer
+ */
+void encode_ble_header(uint8_t *payload) {
+    static ble_encoder_t encoder = {0};
+    ble_encoder_header(&encoder, payload, time(NULL));
+}
+
+/**
+ * @brief Writes bytes 0-2 using the caller's encoder state and clock.
+ * @param enc     Encoder state (counter is incremented)
+ * @param payload Pointer to the payload buffer
+ * @param now     UNIX time to stamp
+ */
+void ble_encoder_header(ble_encoder_t *enc, uint8_t *payload, time_t now) {
     // Generate a timestamp as 2-byte truncated UNIX time
-    time_t now = time(NULL);
     uint16_t timestamp = (uint16_t)(now % 65536);
 
-    payload[0] = counter++;              // Packet counter (rolls over at 255)
+    payload[0] = enc->counter++;         // Packet counter (rolls over at 255)
     payload[1] = timestamp & 0xFF;       // Timestamp LSB
     payload[2] = (timestamp >> 8) & 0xFF;// Timestamp MSB
+}
 
+/**
+ * @brief Writes the fixed-point statistics fields (bytes 3-26).
+ * @param payload     Pointer to the payload buffer
+ * @param temp_stats  Pointer to temperature statistics
+ * @param hum_stats   Pointer to humidity statistics
+ * @param co2_stats   Pointer to CO₂ statistics
+ */
+void encode_ble_stats_fields(uint8_t *payload,
+                             const stats_t *temp_stats,
+                             const stats_t *hum_stats,
+                             const stats_t *co2_stats) {
     // Array of sensor statistics for iteration
     const stats_t *sensors[3] = { temp_stats, hum_stats, co2_stats };
 
@@ -64,3 +94,35 @@ void encode_ble_advertising_data(uint8_t *payload,
         payload[offset + 7] = (uint8_t)((med >> 8)   & 0xFF);
     }
 }
+
+/**
+ * @brief Writes the optional trend fields (bytes 27-32) after the statistics.
+ *
+ * For each sensor (temp, hum, CO2) the sliding-window slope per minute is
+ * stored as a signed little-endian int16, with the same scaling as the
+ * statistics fields (0.01 °C/min, 0.01 %/min, 1 ppm/min), saturated to the
+ * int16 range. The payload must be at least BLE_PAYLOAD_TREND_SIZE bytes.
+ *
+ * @param payload     Pointer to the payload buffer
+ * @param temp_stats  Pointer to temperature statistics (trend fields filled)
+ * @param hum_stats   Pointer to humidity statistics
+ * @param co2_stats   Pointer to CO₂ statistics
+ */
+void encode_ble_trend_fields(uint8_t *payload,
+                             const stats_t *temp_stats,
+                             const stats_t *hum_stats,
+                             const stats_t *co2_stats) {
+    const stats_t *sensors[3] = { temp_stats, hum_stats, co2_stats };
+
+    for (int i = 0; i < 3; i++) {
+        float scale = (i == 2) ? 1.0f : 100.0f;
+        float v = sensors[i]->slope * scale;
+        if (v > INT16_MAX) v = INT16_MAX;
+        if (v < INT16_MIN) v = INT16_MIN;
+        uint16_t slope = (uint16_t)(int16_t)v;
+
+        int offset = BLE_PAYLOAD_SIZE + i * 2;
+        payload[offset]     = (uint8_t)( slope       & 0xFF);
+        payload[offset + 1] = (uint8_t)((slope >> 8) & 0xFF);
+    }
+}
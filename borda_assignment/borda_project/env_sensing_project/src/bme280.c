@@ -70,37 +70,96 @@ int bme280_read_calibration(int fd, uint16_t *T1, int16_t *T2, int16_t *T3) {
 
 /**
  * @brief Applies compensation algorithm to raw temperature using BME280 formula.
- *        Uses T1, T2, T3 calibration coefficients.
+ *        Uses T1, T2, T3 calibration coefficients. Use bme280_read_raw() and
+ *        bme280_compensate() when pressure and humidity are needed too.
  * @param adc_T Raw temperature from bme280_read_raw_temp()
  * @param T1,T2,T3 Calibration parameters
  * @return Compensated temperature in degrees Celsius
  */
 float bme280_calibrate_temp(int32_t adc_T, uint16_t T1, int16_t T2, int16_t T3) {
-    int32_t var1 = ((((adc_T >> 3) - ((int32_t)T1 << 1))) * ((int32_t)T2)) >> 11;
-    int32_t var2 = (((((adc_T >> 4) - ((int32_t)T1)) *
-                      ((adc_T >> 4) - ((int32_t)T1))) >> 12) *
-                    ((int32_t)T3)) >> 14;
-
-    int32_t t_fine = var1 + var2;
-    float T = (t_fine * 5 + 128) >> 8;
-    return T / 100.0f;
+    bme280_calib_t calib = { .T1 = T1, .T2 = T2, .T3 = T3 };
+    int32_t t_fine;
+    return bme280_compensate_T_int32(adc_T, &calib, &t_fine) / 100.0f;
+}
+
+/**
+ * @brief Reads all temperature, pressure and humidity calibration parameters.
+ * @param fd I2C file descriptor
+ * @param calib Output parameters
+ * @return 0 on success, -1 on failure
+ */
+int bme280_read_calibration_full(int fd, bme280_calib_t *calib) {
+    uint8_t tp[BME280_CALIB_TP_LEN], h[BME280_CALIB_H_LEN];
+    if (i2c_read_bytes(fd, 0x88, tp, BME280_CALIB_TP_LEN) != 0 ||
+        i2c_read_bytes(fd, 0xE1, h, BME280_CALIB_H_LEN) != 0)
+        return -1;
+
+    bme280_parse_calibration(tp, h, calib);
+    return 0;
+}
+
+/**
+ * @brief Burst-reads pressure, temperature and humidity (0xF7..0xFE) in one
+ *        transfer, so all three values come from the same measurement cycle.
+ * @param fd I2C file descriptor
+ * @param raw Output raw ADC values
+ * @return 0 on success, -1 on failure
+ */
+int bme280_read_raw(int fd, bme280_raw_t *raw) {
+    uint8_t data[BME280_DATA_LEN];
+    if (i2c_read_bytes(fd, BME280_REG_DATA, data, BME280_DATA_LEN) != 0)
+        return -1;
+
+    bme280_parse_raw(data, raw);
+    return 0;
+}
+
+/**
+ * @brief Unpacks the 0xF7..0xFE data registers (e.g. from an asynchronous
+ *        bus read) into raw ADC values.
+ * @param data Register bytes, press_msb first
+ * @param raw Output raw ADC values
+ */
+void bme280_parse_raw(const uint8_t data[BME280_DATA_LEN], bme280_raw_t *raw) {
+    raw->adc_P = ((int32_t)data[0] << 12) | ((int32_t)data[1] << 4) | (data[2] >> 4);
+    raw->adc_T = ((int32_t)data[3] << 12) | ((int32_t)data[4] << 4) | (data[5] >> 4);
+    raw->adc_H = ((int32_t)data[6] << 8) | data[7];
 }
 
-#include <stdlib.h>
 #include <time.h>
+#include "signal_model.h"
 
 static int bme280_sim_init = 0;
+static signal_model_t sim_temp, sim_hum, sim_press;
 
 /**
- * @brief Simulates BME280 temperature value for testing without real hardware.
- * @return Simulated temperature in Celsius
+ * @brief Seeds the simulated BME280 channels. Runs with the same seed
+ *        produce identical readings.
+ * @param seed Simulation seed
  */
-float bme280_read_temperature(void) {
+void bme280_sim_seed(uint64_t seed) {
+    signal_model_init(&sim_temp,  &SIGNAL_CFG_TEMPERATURE, seed + 1);
+    signal_model_init(&sim_hum,   &SIGNAL_CFG_HUMIDITY,    seed + 2);
+    signal_model_init(&sim_press, &SIGNAL_CFG_PRESSURE,    seed + 3);
+    bme280_sim_init = 1;
+}
+
+/**
+ * @brief Seeds from the clock on first use if bme280_sim_seed() was not called.
+ */
+static void bme280_sim_ensure_init(void) {
     if (!bme280_sim_init) {
-        srand(time(NULL));
-        bme280_sim_init = 1;
+        bme280_sim_seed((uint64_t)time(NULL));
     }
-    return 24.0 + (rand() % 500) / 100.0;  // Range: 24.00 - 29.00 °C
+}
+
+/**
+ * @brief Simulates BME280 temperature value for testing without real hardware.
+ * @return Simulated temperature in Celsius (diurnal drift, noise, spikes, faults)
+ */
+float bme280_read_temperature(void) {
+    bme280_sim_ensure_init();
+    return signal_model_next(&sim_temp);
 }
 
 /**
@@ -108,7 +167,8 @@ float bme280_read_temperature(void) {
  * @return Simulated humidity in percentage
  */
 float bme280_read_humidity(void) {
-    return 40.0 + (rand() % 300) / 10.0;   // Range: 40.0 - 70.0 %
+    bme280_sim_ensure_init();
+    return signal_model_next(&sim_hum);
 }
 
 /**
@@ -116,5 +176,6 @@ float bme280_read_humidity(void) {
  * @return Simulated pressure in hPa
  */
 float bme280_read_pressure(void) {
-    return 1000.0 + (rand() % 100);        // Range: 1000 - 1099 hPa
+    bme280_sim_ensure_init();
+    return signal_model_next(&sim_press);
 }
@@ -0,0 +1,217 @@
+#include "bme280_compensate.h"
+#include <math.h>
+
+/**
+ * @brief Decodes the factory trimming registers into calibration parameters.
+ *        Kept free of any I2C dependency so recorded raw data can be
+ *        reprocessed offline (replay, gateway side).
+ * @param tp    Bytes read from 0x88..0xA1 (temperature, pressure, H1)
+ * @param h     Bytes read from 0xE1..0xE7 (H2..H6)
+ * @param calib Output parameters
+ */
+void bme280_parse_calibration(const uint8_t tp[BME280_CALIB_TP_LEN],
+                              const uint8_t h[BME280_CALIB_H_LEN], bme280_calib_t *calib) {
+    calib->T1 = (uint16_t)(tp[1] << 8 | tp[0]);
+    calib->T2 = (int16_t)(tp[3] << 8 | tp[2]);
+    calib->T3 = (int16_t)(tp[5] << 8 | tp[4]);
+
+    calib->P1 = (uint16_t)(tp[7] << 8 | tp[6]);
+    calib->P2 = (int16_t)(tp[9] << 8 | tp[8]);
+    calib->P3 = (int16_t)(tp[11] << 8 | tp[10]);
+    calib->P4 = (int16_t)(tp[13] << 8 | tp[12]);
+    calib->P5 = (int16_t)(tp[15] << 8 | tp[14]);
+    calib->P6 = (int16_t)(tp[17] << 8 | tp[16]);
+    calib->P7 = (int16_t)(tp[19] << 8 | tp[18]);
+    calib->P8 = (int16_t)(tp[21] << 8 | tp[20]);
+    calib->P9 = (int16_t)(tp[23] << 8 | tp[22]);
+
+    calib->H1 = tp[25];  // 0xA1 (0xA0 is unused)
+    calib->H2 = (int16_t)(h[1] << 8 | h[0]);
+    calib->H3 = h[2];
+    // H4 and H5 are 12-bit values sharing the nibbles of 0xE5
+    calib->H4 = (int16_t)((int8_t)h[3] * 16 | (h[4] & 0x0F));
+    calib->H5 = (int16_t)((int8_t)h[5] * 16 | (h[4] >> 4));
+    calib->H6 = (int8_t)h[6];
+}
+
+/**
+ * @brief Fixed-point temperature compensation (datasheet 4.2.3).
+ * @param adc_T  Raw 20-bit temperature
+ * @param calib  Calibration parameters
+ * @param t_fine Output: fine temperature, required by the P and H steps
+ * @return Temperature in 0.01 °C (5123 = 51.23 °C)
+ */
+int32_t bme280_compensate_T_int32(int32_t adc_T, const bme280_calib_t *calib, int32_t *t_fine) {
+    int32_t var1 = (((adc_T >> 3) - ((int32_t)calib->T1 << 1)) * (int32_t)calib->T2) >> 11;
+    int32_t var2 = (((((adc_T >> 4) - (int32_t)calib->T1) *
+                      ((adc_T >> 4) - (int32_t)calib->T1)) >> 12) *
+                    (int32_t)calib->T3) >> 14;
+
+    *t_fine = var1 + var2;
+    return (*t_fine * 5 + 128) >> 8;
+}
+
+/**
+ * @brief 64-bit fixed-point pressure compensation (datasheet 4.2.3).
+ *        Left shifts of signed values are written as multiplications.
+ * @param adc_P  Raw 20-bit pressure
+ * @param calib  Calibration parameters
+ * @param t_fine Fine temperature from the temperature step
+ * @return Pressure in Pa as Q24.8 (24674867 = 96386.2 Pa), 0 on invalid calibration
+ */
+uint32_t bme280_compensate_P_int64(int32_t adc_P, const bme280_calib_t *calib, int32_t t_fine) {
+    int64_t var1 = (int64_t)t_fine - 128000;
+    int64_t var2 = var1 * var1 * (int64_t)calib->P6;
+    var2 = var2 + var1 * (int64_t)calib->P5 * (1LL << 17);
+    var2 = var2 + (int64_t)calib->P4 * (1LL << 35);
+    var1 = ((var1 * var1 * (int64_t)calib->P3) >> 8) + var1 * (int64_t)calib->P2 * (1LL << 12);
+    var1 = (((1LL << 47) + var1) * (int64_t)calib->P1) >> 33;
+    if (var1 == 0) {
+        return 0;  // Avoid division by zero
+    }
+
+    int64_t p = 1048576 - adc_P;
+    p = ((p * (1LL << 31) - var2) * 3125) / var1;
+    var1 = ((int64_t)calib->P9 * (p >> 13) * (p >> 13)) >> 25;
+    var2 = ((int64_t)calib->P8 * p) >> 19;
+    p = ((p + var1 + var2) >> 8) + (int64_t)calib->P7 * 16;
+    return (uint32_t)p;
+}
+
+/**
+ * @brief 32-bit fixed-point humidity compensation (datasheet 4.2.3).
+ * @param adc_H  Raw 16-bit humidity
+ * @param calib  Calibration parameters
+ * @param t_fine Fine temperature from the temperature step
+ * @return Relative humidity as Q22.10 (47445 = 46.333 %RH)
+ */
+uint32_t bme280_compensate_H_int32(int32_t adc_H, const bme280_calib_t *calib, int32_t t_fine) {
+    int32_t v = t_fine - 76800;
+    v = ((((adc_H * 16384) - ((int32_t)calib->H4 * 1048576) - ((int32_t)calib->H5 * v)) + 16384) >> 15) *
+        (((((((v * (int32_t)calib->H6) >> 10) * (((v * (int32_t)calib->H3) >> 11) + 32768)) >> 10) +
+           2097152) * (int32_t)calib->H2 + 8192) >> 14);
+    v = v - (((((v >> 15) * (v >> 15)) >> 7) * (int32_t)calib->H1) >> 4);
+    v = v < 0 ? 0 : v;
+    v = v > 419430400 ? 419430400 : v;
+    return (uint32_t)(v >> 12);
+}
+
+/**
+ * @brief Floating-point temperature compensation (datasheet 8.1).
+ * @return Temperature in °C; t_fine is written for the P and H steps
+ */
+double bme280_compensate_T_double(int32_t adc_T, const bme280_calib_t *calib, int32_t *t_fine) {
+    double var1 = (adc_T / 16384.0 - calib->T1 / 1024.0) * calib->T2;
+    double var2 = (adc_T / 131072.0 - calib->T1 / 8192.0) *
+                  (adc_T / 131072.0 - calib->T1 / 8192.0) * calib->T3;
+    *t_fine = (int32_t)(var1 + var2);
+    return (var1 + var2) / 5120.0;
+}
+
+/**
+ * @brief Floating-point pressure compensation (datasheet 8.1).
+ * @return Pressure in Pa, 0 on invalid calibration
+ */
+double bme280_compensate_P_double(int32_t adc_P, const bme280_calib_t *calib, int32_t t_fine) {
+    double var1 = t_fine / 2.0 - 64000.0;
+    double var2 = var1 * var1 * calib->P6 / 32768.0;
+    var2 = var2 + var1 * calib->P5 * 2.0;
+    var2 = var2 / 4.0 + calib->P4 * 65536.0;
+    var1 = (calib->P3 * var1 * var1 / 524288.0 + calib->P2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * calib->P1;
+    if (var1 == 0.0) {
+        return 0.0;  // Avoid division by zero
+    }
+
+    double p = 1048576.0 - adc_P;
+    p = (p - var2 / 4096.0) * 6250.0 / var1;
+    var1 = calib->P9 * p * p / 2147483648.0;
+    var2 = p * calib->P8 / 32768.0;
+    return p + (var1 + var2 + calib->P7) / 16.0;
+}
+
+/**
+ * @brief Floating-point humidity compensation (datasheet 8.1).
+ * @return Relative humidity in %RH, clamped to 0..100
+ */
+double bme280_compensate_H_double(int32_t adc_H, const bme280_calib_t *calib, int32_t t_fine) {
+    double h = t_fine - 76800.0;
+    h = (adc_H - (calib->H4 * 64.0 + calib->H5 / 16384.0 * h)) *
+        (calib->H2 / 65536.0 * (1.0 + calib->H6 / 67108864.0 * h * (1.0 + calib->H3 / 67108864.0 * h)));
+    h = h * (1.0 - calib->H1 * h / 524288.0);
+    if (h > 100.0) h = 100.0;
+    if (h < 0.0) h = 0.0;
+    return h;
+}
+
+/**
+ * @brief Compensates one raw triple with the fixed-point path, temperature first
+ *        so the same t_fine feeds pressure and humidity.
+ * @param raw   Raw ADC values
+ * @param calib Calibration parameters
+ * @param out   Temperature (°C), pressure (hPa) and humidity (%RH)
+ */
+void bme280_compensate(const bme280_raw_t *raw, const bme280_calib_t *calib, bme280_reading_t *out) {
+    int32_t t_fine;
+    out->temperature = bme280_compensate_T_int32(raw->adc_T, calib, &t_fine) / 100.0f;
+    out->pressure = bme280_compensate_P_int64(raw->adc_P, calib, t_fine) / 25600.0f;
+    out->humidity = bme280_compensate_H_int32(raw->adc_H, calib, t_fine) / 1024.0f;
+}
+
+/**
+ * @brief Compensates n raw triples in one pass (replay / gateway reprocessing).
+ *        Same math as the double variants, but with the calibration hoisted out
+ *        of the loop and the division guard and clamps written without branches,
+ *        so the compiler can vectorize it (-O3, or -O2 -ftree-vectorize).
+ * @param calib       Calibration parameters of the device that produced the data
+ * @param adc_T,adc_P,adc_H  Raw values (structure-of-arrays, n each)
+ * @param temperature Output in °C
+ * @param pressure    Output in hPa
+ * @param humidity    Output in %RH
+ * @param n           Number of samples
+ */
+void bme280_compensate_batch(const bme280_calib_t *calib,
+                             const int32_t *restrict adc_T, const int32_t *restrict adc_P,
+                             const int32_t *restrict adc_H,
+                             float *restrict temperature, float *restrict pressure,
+                             float *restrict humidity, size_t n) {
+    const double T1 = calib->T1, T2 = calib->T2, T3 = calib->T3;
+    const double P1 = calib->P1, P2 = calib->P2, P3 = calib->P3, P4 = calib->P4, P5 = calib->P5;
+    const double P6 = calib->P6, P7 = calib->P7, P8 = calib->P8, P9 = calib->P9;
+    const double H1 = calib->H1, H2 = calib->H2, H3 = calib->H3;
+    const double H4 = calib->H4, H5 = calib->H5, H6 = calib->H6;
+
+    for (size_t i = 0; i < n; i++) {
+        // Temperature → t_fine
+        double dT1 = adc_T[i] / 16384.0 - T1 / 1024.0;
+        double dT2 = adc_T[i] / 131072.0 - T1 / 8192.0;
+        double t_sum = dT1 * T2 + dT2 * dT2 * T3;
+        double t_fine = (double)(int32_t)t_sum;
+        temperature[i] = (float)(t_sum / 5120.0);
+
+        // Pressure
+        double v1 = t_fine / 2.0 - 64000.0;
+        double v2 = v1 * v1 * P6 / 32768.0;
+        v2 = v2 + v1 * P5 * 2.0;
+        v2 = v2 / 4.0 + P4 * 65536.0;
+        v1 = (P3 * v1 * v1 / 524288.0 + P2 * v1) / 524288.0;
+        v1 = (1.0 + v1 / 32768.0) * P1;
+        double valid = v1 != 0.0;
+        double div = v1 != 0.0 ? v1 : 1.0;
+        double p = 1048576.0 - adc_P[i];
+        p = (p - v2 / 4096.0) * 6250.0 / div;
+        p = p + (P9 * p * p / 2147483648.0 + p * P8 / 32768.0 + P7) / 16.0;
+        pressure[i] = (float)(valid * p / 100.0);
+
+        // Humidity
+        double h = t_fine - 76800.0;
+        h = (adc_H[i] - (H4 * 64.0 + H5 / 16384.0 * h)) *
+            (H2 / 65536.0 * (1.0 + H6 / 67108864.0 * h * (1.0 + H3 / 67108864.0 * h)));
+        h = h * (1.0 - H1 * h / 524288.0);
+        // Clamp to 0..100 via min(a,b) = (a + b - |a - b|) / 2: ordered compares
+        // would block if-conversion unless built with -fno-trapping-math
+        h = (h + 100.0 - fabs(h - 100.0)) / 2.0;
+        h = (h + fabs(h)) / 2.0;
+        humidity[i] = (float)h;
+    }
+}
@@ -0,0 +1,456 @@
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <math.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include "ble_payload.h"
+#include "circular_buffer.h"
+#include "median_filter.h"
+#include "signal_model.h"
+#include "stats.h"
+
+#define DEFAULT_NODES       2000
+#define DEFAULT_DURATION_S  600.0     // Virtual seconds to simulate
+#define DEFAULT_RATE_HZ     1.0       // Samples per virtual second (MEASUREMENT_INTERVAL_SEC on the node)
+#define DEFAULT_PAYLOAD_S   3.0       // Virtual seconds between payloads (BLE_UPDATE_INTERVAL_SEC)
+#define DEFAULT_BATCH       32        // Records per datagram / write()
+#define MAX_THREADS         64
+#define MAX_BATCH           1024
+#define WINDOW_SIZE         5         // Temperature median window, as on the node
+#define GROUP_NODES         MF_BANK_LANES
+#define NODE_ADDR_SIZE      6
+#define FLEET_RECORD_SIZE   (NODE_ADDR_SIZE + BLE_PAYLOAD_SIZE)
+#define NODE_OUI            0xB827EB000000ULL  // Raspberry Pi OUI + node index, as in decoder_bench
+#define SIM_EPOCH           1743800000LL       // UNIX time of virtual t = 0
+
+enum { CH_TEMP, CH_HUM, CH_CO2, CH_COUNT };
+
+typedef enum { SINK_NONE, SINK_UDP, SINK_UNIX, SINK_FILE } sink_kind_t;
+static const char *SINK_NAME[] = { "none", "udp", "unix", "file" };
+
+typedef struct {
+    sink_kind_t kind;
+    int fd;
+} sink_t;
+
+typedef struct {
+    int nodes;
+    int threads;
+    double duration_s;
+    double rate_hz;
+    double payload_s;
+    double speedup;            // Virtual seconds per wall second, 0 = as fast as possible
+    int batch;
+    int use_bank;              // Filter temperature with median_bank_t instead of apply_median_filter
+    uint64_t seed;
+    const char *out;
+
+    // Derived
+    uint64_t ticks;            // Sample ticks per node
+    uint32_t payload_every;    // Sample ticks per payload
+    uint64_t start_ns;         // Shared CLOCK_MONOTONIC start, for --speedup pacing
+} sim_cfg_t;
+
+// Everything one simulated node keeps between samples (what sensor_state_t holds on a Pi)
+typedef struct {
+    signal_model_t sig[CH_COUNT];
+    circular_buffer_t cb[CH_COUNT];
+    float temp_filter_buf[WINDOW_SIZE];
+    uint8_t temp_index, temp_count;
+    ble_encoder_t encoder;
+} node_t;
+
+// Nodes are stepped in groups of MF_BANK_LANES so --bank can filter a whole group at once
+typedef struct {
+    node_t node[GROUP_NODES];
+    median_bank_t bank;
+    int lanes;
+    uint64_t first;            // Fleet index of node[0]
+    uint32_t phase;            // Tick offset, so groups do not all publish on the same tick
+} group_t;
+
+typedef struct {
+    const sim_cfg_t *cfg;
+    const sink_t *sink;
+    group_t *groups;
+    int n_groups;
+    pthread_t tid;
+
+    uint64_t samples, payloads;
+    uint64_t bytes, writes, write_errors;
+    uint64_t late_ticks;       // --speedup: ticks started after their deadline
+    double cpu_s;
+
+    uint32_t out_records;
+    uint8_t out[MAX_BATCH * FLEET_RECORD_SIZE];
+} worker_t;
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static double thread_cpu_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double process_cpu_sec(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 +
+           ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+}
+
+/**
+ * @brief Opens the payload sink: "none", "file:PATH", "unix:PATH" (SOCK_DGRAM)
+ *        or "udp:HOST:PORT".
+ * @return 0 on success, -1 on a bad spec or a failed open/connect
+ */
+static int sink_open(sink_t *sink, const char *spec) {
+    sink->kind = SINK_NONE;
+    sink->fd = -1;
+
+    if (strcmp(spec, "none") == 0) {
+        return 0;
+    } else if (strncmp(spec, "file:", 5) == 0) {
+        sink->kind = SINK_FILE;
+        sink->fd = open(spec + 5, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+        return sink->fd >= 0 ? 0 : -1;
+    } else if (strncmp(spec, "unix:", 5) == 0) {
+        struct sockaddr_un addr = { .sun_family = AF_UNIX };
+        if (strlen(spec + 5) >= sizeof(addr.sun_path)) return -1;
+        strcpy(addr.sun_path, spec + 5);
+        sink->kind = SINK_UNIX;
+        sink->fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (sink->fd < 0) return -1;
+        return connect(sink->fd, (struct sockaddr *)&addr, sizeof(addr));
+    } else if (strncmp(spec, "udp:", 4) == 0) {
+        char host[256];
+        const char *port = strrchr(spec + 4, ':');
+        if (port == NULL || (size_t)(port - (spec + 4)) >= sizeof(host)) return -1;
+        memcpy(host, spec + 4, port - (spec + 4));
+        host[port - (spec + 4)] = '\0';
+
+        struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM }, *res;
+        if (getaddrinfo(host, port + 1, &hints, &res) != 0) return -1;
+        sink->kind = SINK_UDP;
+        sink->fd = socket(res->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        int rc = sink->fd >= 0 ? connect(sink->fd, res->ai_addr, res->ai_addrlen) : -1;
+        freeaddrinfo(res);
+        return rc;
+    }
+    return -1;
+}
+
+static void sink_close(sink_t *sink) {
+    if (sink->fd >= 0) close(sink->fd);
+    sink->fd = -1;
+}
+
+/**
+ * @brief Hands the worker's pending records to the sink as one datagram or write().
+ *        Failed sends (no listener, full socket buffer) are counted, not retried.
+ */
+static void flush_records(worker_t *w) {
+    if (w->out_records == 0) return;
+    size_t len = (size_t)w->out_records * FLEET_RECORD_SIZE;
+    w->out_records = 0;
+    if (w->sink->kind == SINK_NONE) return;
+
+    ssize_t n = w->sink->kind == SINK_FILE ? write(w->sink->fd, w->out, len)
+                                           : send(w->sink->fd, w->out, len, 0);
+    w->writes++;
+    if (n == (ssize_t)len) {
+        w->bytes += len;
+    } else {
+        w->write_errors++;
+    }
+}
+
+/**
+ * @brief Statistics and payload for one node, exactly as the node's BLE tick does
+ *        it, stamped with the node's own encoder and the virtual clock. The record
+ *        is the 6-byte little-endian node address followed by the payload.
+ */
+static void publish(worker_t *w, group_t *g, int lane, uint64_t tick) {
+    node_t *n = &g->node[lane];
+    float buf[BUFFER_SIZE];
+    stats_t stats[CH_COUNT];
+
+    for (int ch = 0; ch < CH_COUNT; ch++) {
+        uint8_t count = cb_get_all(&n->cb[ch], buf);
+        compute_statistics(buf, count, &stats[ch]);
+    }
+
+    uint8_t *rec = w->out + (size_t)w->out_records * FLEET_RECORD_SIZE;
+    uint64_t addr = NODE_OUI + g->first + lane;
+    for (int b = 0; b < NODE_ADDR_SIZE; b++) {
+        rec[b] = (uint8_t)(addr >> (8 * b));
+    }
+    encode_ble_stats_fields(rec + NODE_ADDR_SIZE, &stats[CH_TEMP], &stats[CH_HUM], &stats[CH_CO2]);
+    ble_encoder_header(&n->encoder, rec + NODE_ADDR_SIZE,
+                       (time_t)(SIM_EPOCH + (int64_t)(tick / w->cfg->rate_hz)));
+
+    w->payloads++;
+    if (++w->out_records == (uint32_t)w->cfg->batch) {
+        flush_records(w);
+    }
+}
+
+/**
+ * @brief Advances every node of a group by one sample tick: read, filter, push,
+ *        and publish on the group's payload ticks.
+ */
+static void step_group(worker_t *w, group_t *g, uint64_t tick) {
+    const sim_cfg_t *cfg = w->cfg;
+    float temp[GROUP_NODES];
+
+    for (int l = 0; l < g->lanes; l++) {
+        node_t *n = &g->node[l];
+        temp[l] = signal_model_next(&n->sig[CH_TEMP]);
+        cb_push(&n->cb[CH_HUM], signal_model_next(&n->sig[CH_HUM]));
+        cb_push(&n->cb[CH_CO2], signal_model_next(&n->sig[CH_CO2]));
+    }
+
+    if (cfg->use_bank) {
+        median_bank_apply(&g->bank, temp, temp);
+    } else {
+        for (int l = 0; l < g->lanes; l++) {
+            node_t *n = &g->node[l];
+            temp[l] = apply_median_filter(temp[l], n->temp_filter_buf, WINDOW_SIZE,
+                                          &n->temp_index, &n->temp_count);
+        }
+    }
+    for (int l = 0; l < g->lanes; l++) {
+        cb_push(&g->node[l].cb[CH_TEMP], temp[l]);
+    }
+    w->samples += g->lanes;
+
+    if ((tick + 1 + g->phase) % cfg->payload_every == 0) {
+        for (int l = 0; l < g->lanes; l++) {
+            publish(w, g, l, tick);
+        }
+    }
+}
+
+/**
+ * @brief Runs the worker's slice of groups through every tick. With --speedup,
+ *        tick k is released at start + k / (rate × speedup) of wall time.
+ */
+static void *worker_thread(void *arg) {
+    worker_t *w = arg;
+    const sim_cfg_t *cfg = w->cfg;
+    double tick_ns = cfg->speedup > 0 ? 1e9 / (cfg->rate_hz * cfg->speedup) : 0;
+    double cpu0 = thread_cpu_sec();
+
+    for (uint64_t tick = 0; tick < cfg->ticks; tick++) {
+        if (tick_ns > 0) {
+            uint64_t deadline = cfg->start_ns + (uint64_t)(tick * tick_ns);
+            if (now_ns() > deadline) {
+                w->late_ticks++;
+            } else {
+                struct timespec ts = { (time_t)(deadline / 1000000000ull), (long)(deadline % 1000000000ull) };
+                clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+            }
+        }
+        for (int i = 0; i < w->n_groups; i++) {
+            step_group(w, &w->groups[i], tick);
+        }
+    }
+    flush_records(w);
+
+    w->cpu_s = thread_cpu_sec() - cpu0;
+    return NULL;
+}
+
+/**
+ * @brief Allocates and seeds the fleet. Node i's channels are seeded from
+ *        seed + i, and its counter starts at a node-specific offset so
+ *        wraparound happens at different times across the fleet.
+ */
+static group_t *create_fleet(const sim_cfg_t *cfg, int *n_groups) {
+    static const signal_cfg_t *const CHANNEL_CFG[CH_COUNT] = {
+        &SIGNAL_CFG_TEMPERATURE, &SIGNAL_CFG_HUMIDITY, &SIGNAL_CFG_CO2
+    };
+
+    *n_groups = (cfg->nodes + GROUP_NODES - 1) / GROUP_NODES;
+    group_t *groups = calloc(*n_groups, sizeof(group_t));
+    if (groups == NULL) return NULL;
+
+    for (int gi = 0; gi < *n_groups; gi++) {
+        group_t *g = &groups[gi];
+        g->first = (uint64_t)gi * GROUP_NODES;
+        g->lanes = cfg->nodes - (int)g->first < GROUP_NODES ? cfg->nodes - (int)g->first : GROUP_NODES;
+        g->phase = (uint32_t)gi % cfg->payload_every;
+        median_bank_init(&g->bank, WINDOW_SIZE, (uint8_t)g->lanes);
+
+        for (int l = 0; l < g->lanes; l++) {
+            node_t *n = &g->node[l];
+            uint64_t id = g->first + l;
+            for (int ch = 0; ch < CH_COUNT; ch++) {
+                signal_cfg_t sc = *CHANNEL_CFG[ch];
+                sc.dt_s = (float)(1.0 / cfg->rate_hz);
+                signal_model_init(&n->sig[ch], &sc, cfg->seed + id * CH_COUNT + ch);
+                cb_init(&n->cb[ch]);
+            }
+            n->encoder.counter = (uint8_t)(id * 37);
+        }
+    }
+    return groups;
+}
+
+/**
+ * @brief Fleet-scale node simulator: thousands of virtual nodes run the node's
+ *        filter → compute_statistics → BLE encoding pipeline in one process,
+ *        spread over a small thread pool, and their payloads go to a sink.
+ *
+ *        --nodes=N            virtual nodes (default DEFAULT_NODES)
+ *        --threads=N          worker threads (default: online CPUs)
+ *        --duration=S         virtual seconds to simulate (default 600)
+ *        --rate=HZ            samples per virtual second per node (default 1)
+ *        --payload-period=S   virtual seconds between payloads (default 3)
+ *        --speedup=X          pace virtual time at X × real time (default 0 = unpaced)
+ *        --out=SPEC           none | file:PATH | unix:PATH | udp:HOST:PORT (default none)
+ *        --batch=N            records per datagram / write (default 32, 1 = one per payload)
+ *        --bank               filter temperature with the 16-lane median bank
+ *        --seed=N             simulation seed (default 1)
+ */
+int main(int argc, char *argv[]) {
+    sim_cfg_t cfg = {
+        .nodes = DEFAULT_NODES, .threads = (int)sysconf(_SC_NPROCESSORS_ONLN),
+        .duration_s = DEFAULT_DURATION_S, .rate_hz = DEFAULT_RATE_HZ, .payload_s = DEFAULT_PAYLOAD_S,
+        .batch = DEFAULT_BATCH, .seed = 1, .out = "none"
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (strncmp(a, "--nodes=", 8) == 0) {
+            cfg.nodes = atoi(a + 8);
+        } else if (strncmp(a, "--threads=", 10) == 0) {
+            cfg.threads = atoi(a + 10);
+        } else if (strncmp(a, "--duration=", 11) == 0) {
+            cfg.duration_s = atof(a + 11);
+        } else if (strncmp(a, "--rate=", 7) == 0) {
+            cfg.rate_hz = atof(a + 7);
+        } else if (strncmp(a, "--payload-period=", 17) == 0) {
+            cfg.payload_s = atof(a + 17);
+        } else if (strncmp(a, "--speedup=", 10) == 0) {
+            cfg.speedup = atof(a + 10);
+        } else if (strncmp(a, "--out=", 6) == 0) {
+            cfg.out = a + 6;
+        } else if (strncmp(a, "--batch=", 8) == 0) {
+            cfg.batch = atoi(a + 8);
+        } else if (strcmp(a, "--bank") == 0) {
+            cfg.use_bank = 1;
+        } else if (strncmp(a, "--seed=", 7) == 0) {
+            cfg.seed = strtoull(a + 7, NULL, 0);
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", a);
+            return 1;
+        }
+    }
+
+    if (cfg.nodes < 1 || cfg.rate_hz <= 0 || cfg.duration_s <= 0 || cfg.payload_s <= 0 ||
+        cfg.speedup < 0 || cfg.batch < 1 || cfg.batch > MAX_BATCH) {
+        fprintf(stderr, "❌ Invalid configuration\n");
+        return 1;
+    }
+    cfg.ticks = (uint64_t)llround(cfg.duration_s * cfg.rate_hz);
+    if (cfg.ticks < 1) {
+        fprintf(stderr, "❌ Invalid configuration: --duration × --rate is under one tick\n");
+        return 1;
+    }
+    long every = lround(cfg.payload_s * cfg.rate_hz);
+    cfg.payload_every = every < 1 ? 1 : (uint32_t)every;
+
+    sink_t sink;
+    if (sink_open(&sink, cfg.out) != 0) {
+        fprintf(stderr, "❌ Cannot open output: %s\n", cfg.out);
+        return 1;
+    }
+
+    int n_groups;
+    group_t *groups = create_fleet(&cfg, &n_groups);
+    if (cfg.threads < 1) cfg.threads = 1;
+    if (cfg.threads > MAX_THREADS) cfg.threads = MAX_THREADS;
+    if (cfg.threads > n_groups) cfg.threads = n_groups;
+    worker_t *workers = calloc(cfg.threads, sizeof(worker_t));
+    if (groups == NULL || workers == NULL) {
+        fprintf(stderr, "❌ Out of memory for %d nodes\n", cfg.nodes);
+        return 1;
+    }
+
+    printf("🛰️  Fleet simulation: %d nodes, %d threads, %.3g Hz sampling, payload every %.3g s, "
+           "%.0f s virtual (%s), %s median, output %s\n",
+           cfg.nodes, cfg.threads, cfg.rate_hz, cfg.payload_s, cfg.duration_s,
+           cfg.speedup > 0 ? "paced" : "unpaced", cfg.use_bank ? "banked" : "scalar", cfg.out);
+
+    // Contiguous slices of groups per thread
+    double cpu0 = process_cpu_sec();
+    cfg.start_ns = now_ns();
+    for (int t = 0, next = 0; t < cfg.threads; t++) {
+        worker_t *w = &workers[t];
+        int share = n_groups / cfg.threads + (t < n_groups % cfg.threads);
+        w->cfg = &cfg;
+        w->sink = &sink;
+        w->groups = &groups[next];
+        w->n_groups = share;
+        next += share;
+        if (pthread_create(&w->tid, NULL, worker_thread, w) != 0) {
+            fprintf(stderr, "❌ Failed to start worker %d\n", t);
+            return 1;
+        }
+    }
+
+    uint64_t samples = 0, payloads = 0, bytes = 0, writes = 0, write_errors = 0, late = 0;
+    double thread_cpu_min = 1e300, thread_cpu_max = 0;
+    for (int t = 0; t < cfg.threads; t++) {
+        worker_t *w = &workers[t];
+        pthread_join(w->tid, NULL);
+        samples += w->samples;
+        payloads += w->payloads;
+        bytes += w->bytes;
+        writes += w->writes;
+        write_errors += w->write_errors;
+        late += w->late_ticks;
+        if (w->cpu_s < thread_cpu_min) thread_cpu_min = w->cpu_s;
+        if (w->cpu_s > thread_cpu_max) thread_cpu_max = w->cpu_s;
+    }
+    double wall = (now_ns() - cfg.start_ns) / 1e9;
+    double cpu = process_cpu_sec() - cpu0;
+    double virt = cfg.ticks / cfg.rate_hz;
+    double node_cpu_us = cpu / cfg.nodes / virt * 1e6;  // CPU µs per node per virtual second
+
+    printf("\n📊 Fleet results\n");
+    printf("   Wall time        : %.2f s (%.1f× real time)\n", wall, virt / wall);
+    printf("   Samples          : %llu (%.0f/s)\n", (unsigned long long)samples, samples / wall);
+    printf("   Payloads         : %llu (%.0f/s)\n", (unsigned long long)payloads, payloads / wall);
+    printf("   Output           : %s, %llu bytes in %llu writes, %llu failed\n", SINK_NAME[sink.kind],
+           (unsigned long long)bytes, (unsigned long long)writes, (unsigned long long)write_errors);
+    printf("   CPU time         : %.2f s (threads %.2f–%.2f s)\n", cpu, thread_cpu_min, thread_cpu_max);
+    printf("   CPU per payload  : %.2f µs (incl. %u samples per node)\n",
+           payloads ? cpu / payloads * 1e6 : 0.0, cfg.payload_every);
+    printf("   CPU per node     : %.2f µs per virtual second → ~%.0f nodes per core in real time\n",
+           node_cpu_us, node_cpu_us > 0 ? 1e6 / node_cpu_us : 0.0);
+    if (cfg.speedup > 0) {
+        printf("   Behind schedule  : %llu of %llu thread ticks\n",
+               (unsigned long long)late, (unsigned long long)(cfg.ticks * cfg.threads));
+    }
+
+    sink_close(&sink);
+    free(workers);
+    free(groups);
+    return 0;
+}
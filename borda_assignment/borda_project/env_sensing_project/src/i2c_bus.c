@@ -0,0 +1,200 @@
+#include "i2c_bus.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+/**
+ * @brief Runs a batch of register reads as one combined I2C_RDWR transaction:
+ *        for each request a write of the register address followed by a read,
+ *        with repeated starts in between, across any mix of devices.
+ * @return 0 on success, -errno if the transfer failed
+ */
+static int transfer(int fd, i2c_request_t *reqs, int n) {
+    struct i2c_msg msgs[2 * I2C_BUS_MAX_BATCH];
+    for (int i = 0; i < n; i++) {
+        msgs[2 * i]     = (struct i2c_msg){ .addr = reqs[i].addr, .flags = 0,        .len = 1,           .buf = &reqs[i].reg };
+        msgs[2 * i + 1] = (struct i2c_msg){ .addr = reqs[i].addr, .flags = I2C_M_RD, .len = reqs[i].len, .buf = reqs[i].data };
+    }
+    struct i2c_rdwr_ioctl_data rdwr = { .msgs = msgs, .nmsgs = (uint32_t)(2 * n) };
+    return ioctl(fd, I2C_RDWR, &rdwr) < 0 ? -errno : 0;
+}
+
+/**
+ * @brief Bus worker: waits for a flushed batch, executes it and posts completions.
+ *        All blocking bus I/O for this adapter happens on this thread.
+ *
+ * A batch of several reads goes out as one combined transfer. Some adapters
+ * accept only one read message per transfer, and it must be the last message
+ * (the Pi's i2c-bcm2835 is one of them). They fail a combined transfer with
+ * EOPNOTSUPP. The first time that happens, bus->single_read is set and every
+ * later read is sent as its own transfer, so the combined attempt is not
+ * wasted on each batch. If a device NAKs (EREMOTEIO/ENXIO), only that batch
+ * is split and retried read by read, so the other devices still complete.
+ * Any other error fails the whole batch.
+ */
+static void *bus_thread(void *arg) {
+    i2c_bus_t *bus = arg;
+    i2c_request_t batch[I2C_BUS_MAX_BATCH];
+
+    while (1) {
+        pthread_mutex_lock(&bus->submit_lock);
+        while (bus->running && !bus->flush_requested &&
+               i2c_req_ring_count(&bus->submitted) < I2C_BUS_MAX_BATCH) {
+            pthread_cond_wait(&bus->submit_cond, &bus->submit_lock);
+        }
+        uint32_t n = i2c_req_ring_pop_bulk(&bus->submitted, batch, I2C_BUS_MAX_BATCH);
+        if (i2c_req_ring_is_empty(&bus->submitted)) {
+            bus->flush_requested = 0;
+        }
+        int stop = !bus->running && n == 0;
+        pthread_mutex_unlock(&bus->submit_lock);
+
+        if (stop) break;
+        if (n == 0) continue;
+
+        int err = 0;
+        if (n == 1 || !bus->single_read) {
+            err = transfer(bus->fd, batch, (int)n);
+            bus->transfers++;
+            if (err == -EOPNOTSUPP && n > 1) bus->single_read = 1;
+        }
+
+        int split = n > 1 && (bus->single_read || err == -EREMOTEIO || err == -ENXIO);
+        for (uint32_t i = 0; i < n; i++) {
+            if (split) {
+                batch[i].status = transfer(bus->fd, &batch[i], 1) == 0 ? 0 : -1;
+                bus->transfers++;
+            } else {
+                batch[i].status = err == 0 ? 0 : -1;
+            }
+        }
+
+        pthread_mutex_lock(&bus->done_lock);
+        for (uint32_t i = 0; i < n; i++) {
+            if (batch[i].status != 0) bus->failures++;
+            if (!i2c_req_ring_push(&bus->completed, batch[i])) bus->failures++;  // Caller not draining
+        }
+        bus->requests += n;
+        pthread_cond_broadcast(&bus->done_cond);
+        pthread_mutex_unlock(&bus->done_lock);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Opens an I2C adapter and starts its worker thread. Run one bus per
+ *        /dev/i2c-N to sample several adapters in parallel.
+ *        I2C_RDWR addresses each message directly, so no I2C_SLAVE is needed.
+ * @param bus         Bus state
+ * @param device_path Adapter, e.g. "/dev/i2c-1"
+ * @return 0 on success, -1 on failure
+ */
+int i2c_bus_start(i2c_bus_t *bus, const char *device_path) {
+    memset(bus, 0, sizeof(*bus));
+    snprintf(bus->path, sizeof(bus->path), "%s", device_path);
+    i2c_req_ring_init(&bus->submitted);
+    i2c_req_ring_init(&bus->completed);
+    pthread_mutex_init(&bus->submit_lock, NULL);
+    pthread_cond_init(&bus->submit_cond, NULL);
+    pthread_mutex_init(&bus->done_lock, NULL);
+    pthread_cond_init(&bus->done_cond, NULL);
+
+    bus->fd = open(device_path, O_RDWR);
+    if (bus->fd < 0) {
+        perror("Failed to open I2C bus");
+        return -1;
+    }
+
+    bus->running = 1;
+    if (pthread_create(&bus->thread, NULL, bus_thread, bus) != 0) {
+        bus->running = 0;
+        close(bus->fd);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Queues a register read. Nothing is sent until i2c_bus_flush(), so all
+ *        reads of one tick go out in a single transaction.
+ * @param bus  Bus state
+ * @param tag  Caller-defined id returned with the completion
+ * @param addr 7-bit device address
+ * @param reg  Start register
+ * @param len  Bytes to read (1..I2C_BUS_MAX_READ)
+ * @return 0 on success, -1 if the queue is full or len is invalid
+ */
+int i2c_bus_submit(i2c_bus_t *bus, uint32_t tag, uint8_t addr, uint8_t reg, uint8_t len) {
+    if (len == 0 || len > I2C_BUS_MAX_READ) return -1;
+
+    i2c_request_t req = { .tag = tag, .addr = addr, .reg = reg, .len = len };
+    pthread_mutex_lock(&bus->submit_lock);
+    int ok = i2c_req_ring_push(&bus->submitted, req);
+    if (ok && i2c_req_ring_count(&bus->submitted) >= I2C_BUS_MAX_BATCH) {
+        pthread_cond_signal(&bus->submit_cond);  // A full batch goes out right away
+    }
+    pthread_mutex_unlock(&bus->submit_lock);
+    return ok ? 0 : -1;
+}
+
+/**
+ * @brief Hands all queued reads to the worker. Returns immediately; the
+ *        caller can keep processing while the bus is busy.
+ */
+void i2c_bus_flush(i2c_bus_t *bus) {
+    pthread_mutex_lock(&bus->submit_lock);
+    bus->flush_requested = 1;
+    pthread_cond_signal(&bus->submit_cond);
+    pthread_mutex_unlock(&bus->submit_lock);
+}
+
+/**
+ * @brief Blocks until a completed request is available.
+ * @param bus Bus state
+ * @param out Completed request (check out->status)
+ * @return 0 on success, -1 if the bus was stopped and nothing is left
+ */
+int i2c_bus_wait(i2c_bus_t *bus, i2c_request_t *out) {
+    pthread_mutex_lock(&bus->done_lock);
+    while (i2c_req_ring_is_empty(&bus->completed) && !bus->stopped) {
+        pthread_cond_wait(&bus->done_cond, &bus->done_lock);
+    }
+    int ok = i2c_req_ring_pop(&bus->completed, out);
+    pthread_mutex_unlock(&bus->done_lock);
+    return ok ? 0 : -1;
+}
+
+/**
+ * @brief Non-blocking variant of i2c_bus_wait().
+ * @return 0 if a completion was returned, -1 if none is ready
+ */
+int i2c_bus_poll(i2c_bus_t *bus, i2c_request_t *out) {
+    pthread_mutex_lock(&bus->done_lock);
+    int ok = i2c_req_ring_pop(&bus->completed, out);
+    pthread_mutex_unlock(&bus->done_lock);
+    return ok ? 0 : -1;
+}
+
+/**
+ * @brief Executes anything still queued, stops the worker and closes the adapter.
+ */
+void i2c_bus_stop(i2c_bus_t *bus) {
+    pthread_mutex_lock(&bus->submit_lock);
+    int was_running = bus->running;
+    bus->running = 0;
+    pthread_cond_signal(&bus->submit_cond);
+    pthread_mutex_unlock(&bus->submit_lock);
+    if (!was_running) return;
+    pthread_join(bus->thread, NULL);
+
+    pthread_mutex_lock(&bus->done_lock);
+    bus->stopped = 1;
+    pthread_cond_broadcast(&bus->done_cond);  // Release any waiter
+    pthread_mutex_unlock(&bus->done_lock);
+    close(bus->fd);
+}
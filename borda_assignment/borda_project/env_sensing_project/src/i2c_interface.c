@@ -7,10 +7,24 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include "signal_model.h"
 
 #define BME280_ADDR 0x76
 
 static int initialized = 0;
+static signal_model_t sim_co2, sim_light;
+
+/**
+ * @brief Seeds every simulated I2C device (BME280 channels, CO₂, light).
+ *        Runs with the same seed produce identical readings.
+ * @param seed Simulation seed
+ */
+void i2c_sim_seed(uint64_t seed) {
+    bme280_sim_seed(seed);
+    signal_model_init(&sim_co2,   &SIGNAL_CFG_CO2,   seed + 4);
+    signal_model_init(&sim_light, &SIGNAL_CFG_LIGHT, seed + 5);
+    initialized = 1;
+}
 
 /**
  * @brief Opens the I2C device file.
@@ -107,10 +121,9 @@ int i2c_close(int fd) {
  * @return Simulated sensor reading, or -1.0 if invalid
  */
 float i2c_sensor_read(uint8_t device_address, sensor_type_t type) {
-    // Initialize random generator once
+    // Seed from the clock once if i2c_sim_seed() was not called
     if (!initialized) {
-        srand(time(NULL));
-        initialized = 1;
+        i2c_sim_seed((uint64_t)time(NULL));
     }
 
     // Simulated data sources
@@ -127,12 +140,12 @@ float i2c_sensor_read(uint8_t device_address, sensor_type_t type) {
 
     // Simulated CO₂ sensor
     if (device_address == 0x5A && type == SENSOR_CO2) {
-        return 400 + rand() % 200;  // Random value between 400–600 ppm
+        return signal_model_next(&sim_co2);    // Diurnal occupancy cycle, 400–5000 ppm
     }
 
     // Simulated light sensor
     if (device_address == 0x62 && type == SENSOR_LIGHT) {
-        return 100 + rand() % 900;  // Random value between 100–1000 lux
+        return signal_model_next(&sim_light);  // Daylight cycle with steps (lights on/off)
     }
 
     // Unknown device or sensor type
@@ -3,18 +3,100 @@
 #include <signal.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <time.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
 #include "i2c_interface.h"
 #include "bme280.h"
 #include "median_filter.h"
 #include "circular_buffer.h"
 #include "stats.h"
 #include "ble_payload.h"
+#include "rt_sched.h"
+#include "adaptive.h"
+#include "quantile.h"
+#include "stream_server.h"
+#include "i2c_bus.h"
+#include "trend.h"
+#include "persist.h"
 
 #define WINDOW_SIZE 5                     // Median filter window size
 #define I2C_DEV "/dev/i2c-1"              // I2C device path on Linux
 #define MEASUREMENT_INTERVAL_SEC 1       // Sensor read interval
 #define BLE_UPDATE_INTERVAL_SEC 3        // BLE payload update interval
+#define RT_HIST_FILE "rt_latency.hist"    // Latency histogram written on exit in --rt mode
+#define SOD_HEARTBEAT_SEC 60              // --adaptive: publish at least this often
+#define HOLT_ALPHA 0.3f                   // --holt: level smoothing
+#define HOLT_BETA 0.1f                    // --holt: trend smoothing
+#define CO2_RISE_ALERT_PPM_MIN 50.0f      // Ventilation alert: CO₂ rising faster than this
+#define TREND_ALERT_MIN_R2 0.5f           // ...and the rise is a real trend, not noise
+#define STATE_DEFAULT_PATH "env_sensor.state" // Memory-mapped window/filter state for warm restarts
+#define STATE_VERSION 2                   // Bump whenever sensor_state_t changes
+#define STATE_MAX_AGE_SEC 300             // Older state is discarded instead of resumed
+#define BATCH_MAX_SAMPLES 64              // --batch: largest block (one BUFFER_SIZE of samples)
+#define BATCH_TIMER_SLACK_NS 50000000L    // --batch: let the kernel coalesce sample wake-ups (50 ms)
+
+enum { CH_TEMP, CH_HUM, CH_CO2, CH_COUNT };
+
+// --adaptive thresholds: {min period, max period, stable rate, active rate, active variance}
+static const adaptive_cfg_t ADAPTIVE_CFG[CH_COUNT] = {
+    { MEASUREMENT_INTERVAL_SEC, 16.0f, 0.005f, 0.05f,   0.05f },  // °C
+    { MEASUREMENT_INTERVAL_SEC, 16.0f, 0.02f,  0.2f,    1.0f  },  // %
+    { MEASUREMENT_INTERVAL_SEC, 16.0f, 0.5f,   5.0f,  100.0f  },  // ppm
+};
+
+// --adaptive: publish only if an encoded field moves more than this (0.10 °C, 0.50 %, 10 ppm)
+static const uint16_t SOD_FIELD_DELTA[BLE_SENSOR_COUNT] = { 10, 50, 10 };
+
+// Time-based windows for percentile reporting: last 1 min, 15 min, 24 h
+enum { WIN_1M, WIN_15M, WIN_24H, WIN_COUNT };
+static const float WINDOW_SPAN_SEC[WIN_COUNT] = { 60.0f, 900.0f, 86400.0f };
+static const char *WINDOW_LABEL[WIN_COUNT] = { "1m", "15m", "24h" };
+static const char *CHANNEL_LABEL[CH_COUNT] = { "Temp", "Hum ", "CO₂ " };
+
+// Everything a restart should resume from. Lives in the mapped state file and
+// is updated in place; must stay free of pointers and monotonic timestamps.
+typedef struct {
+    circular_buffer_t cb[CH_COUNT];
+    float temp_filter_buf[WINDOW_SIZE];
+    uint8_t temp_index, temp_count;
+    ble_encoder_t encoder;
+    time_window_t windows[CH_COUNT][WIN_COUNT];
+} sensor_state_t;
+
+// --batch: raw captures since the last burst, processed together before each payload
+typedef struct {
+    int32_t adc_T[BATCH_MAX_SAMPLES];
+    int32_t adc_P[BATCH_MAX_SAMPLES];
+    int32_t adc_H[BATCH_MAX_SAMPLES];
+    float co2[BATCH_MAX_SAMPLES];
+    double mono[BATCH_MAX_SAMPLES];   // CLOCK_MONOTONIC capture time
+    double wall[BATCH_MAX_SAMPLES];   // CLOCK_REALTIME capture time
+    uint32_t count;
+} sample_block_t;
+
+// Static so large state is not on the stack and is covered by mlockall in --rt mode
+static sensor_state_t memory_state;   // Used when the state file is disabled or unavailable
+static persist_t state_file = { .fd = -1 };   // fd -1 until opened, so --no-state never closes stdin
+static stream_server_t stream;
+static i2c_bus_t bus;
+static trend_t trends[CH_COUNT];
+static sample_block_t block;
+
+// Completion tags for the asynchronous bus reads issued each tick
+enum { REQ_BME280_DATA };
+
+typedef struct {
+    rt_config_t rt;
+    int adaptive;
+    uint64_t seed;     // Simulation seed, printed so a run can be reproduced
+    const char *stream_path;  // Unix socket for live samples, NULL = disabled
+    int trend;         // Append slope fields to the BLE payload
+    int holt;          // Holt double-exponential smoothing on every channel
+    const char *state_path;   // Warm-restart state file, NULL = disabled
+    int batch;         // Samples per burst, 0 = process every sample as it is read
+} app_options_t;
 
 volatile bool keep_running = true;
 
@@ -27,9 +109,275 @@ void handle_sigint(int sig) {
     printf("\n🛑 Terminating program...\n");
 }
 
-int main() {
+/**
+ * @brief Parses the command line options:
+ *        --rt            enable SCHED_FIFO + mlockall for the acquisition loop
+ *        --rt-prio=N     SCHED_FIFO priority (default RT_DEFAULT_PRIORITY)
+ *        --rt-cpu=N      pin the acquisition loop to CPU N (default: no pinning)
+ *        --adaptive      per-channel adaptive sampling + send-on-delta publishing
+ *        --seed=N        seed for the simulated channels (default: current time)
+ *        --stream[=PATH] serve live samples on a Unix socket (default STREAM_DEFAULT_PATH)
+ *        --trend         append per-channel slopes to the BLE payload (BLE_PAYLOAD_TREND_SIZE;
+ *                        needs extended advertising, see ble_advertise.py)
+ *        --holt          enable Holt smoothing of level and trend
+ *        --state=PATH    warm-restart state file (default STATE_DEFAULT_PATH)
+ *        --no-state      start with empty windows and keep state in memory only
+ *        --batch[=K]     capture K raw samples, then filter/encode them in one burst
+ *                        (default K: samples per BLE update)
+ */
+static void parse_args(int argc, char *argv[], app_options_t *opts) {
+    rt_config_t *rt = &opts->rt;
+    opts->adaptive = 0;
+    opts->seed = (uint64_t)time(NULL);
+    opts->stream_path = NULL;
+    opts->trend = 0;
+    opts->holt = 0;
+    opts->state_path = STATE_DEFAULT_PATH;
+    opts->batch = 0;
+    rt->enabled = 0;
+    rt->priority = RT_DEFAULT_PRIORITY;
+    rt->cpu = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rt") == 0) {
+            rt->enabled = 1;
+        } else if (strncmp(argv[i], "--rt-prio=", 10) == 0) {
+            rt->enabled = 1;
+            rt->priority = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--rt-cpu=", 9) == 0) {
+            rt->enabled = 1;
+            rt->cpu = atoi(argv[i] + 9);
+        } else if (strcmp(argv[i], "--adaptive") == 0) {
+            opts->adaptive = 1;
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            opts->seed = strtoull(argv[i] + 7, NULL, 0);
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            opts->stream_path = STREAM_DEFAULT_PATH;
+        } else if (strncmp(argv[i], "--stream=", 9) == 0) {
+            opts->stream_path = argv[i] + 9;
+        } else if (strcmp(argv[i], "--trend") == 0) {
+            opts->trend = 1;
+        } else if (strcmp(argv[i], "--holt") == 0) {
+            opts->holt = 1;
+        } else if (strncmp(argv[i], "--state=", 8) == 0) {
+            opts->state_path = argv[i] + 8;
+        } else if (strcmp(argv[i], "--no-state") == 0) {
+            opts->state_path = NULL;
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            opts->batch = BLE_UPDATE_INTERVAL_SEC / MEASUREMENT_INTERVAL_SEC;
+        } else if (strncmp(argv[i], "--batch=", 8) == 0) {
+            opts->batch = atoi(argv[i] + 8);
+            if (opts->batch < 1) opts->batch = 1;
+            if (opts->batch > BATCH_MAX_SAMPLES) opts->batch = BATCH_MAX_SAMPLES;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+        }
+    }
+}
+
+/**
+ * @brief Current CLOCK_REALTIME in seconds.
+ */
+static double wall_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Attaches the warm-restart state: resumes the mapped file if it is
+ *        valid and recent, otherwise starts with empty buffers and windows.
+ * @return State to use for the rest of the run
+ */
+static sensor_state_t *attach_state(const char *path) {
+    sensor_state_t *st = &memory_state;
+    persist_status_t status = PERSIST_FAILED;
+
+    if (path) {
+        status = persist_open(&state_file, path, STATE_VERSION, sizeof(sensor_state_t),
+                              STATE_MAX_AGE_SEC, wall_time());
+    }
+    if (status == PERSIST_RESTORED) {
+        st = state_file.data;
+        printf("♻️  Resumed state from %s (%u/%u/%u samples buffered, saved %.0f s ago)\n", path,
+               float_ring_count(&st->cb[CH_TEMP]), float_ring_count(&st->cb[CH_HUM]),
+               float_ring_count(&st->cb[CH_CO2]), wall_time() - state_file.hdr->saved_at);
+        return st;
+    }
+
+    if (status == PERSIST_FRESH) {
+        st = state_file.data;
+        printf("🆕 New state in %s (%s)\n", path, state_file.reason);
+    } else if (path) {
+        printf("❌ Failed to map state file %s, state is kept in memory only\n", path);
+    }
+
+    for (int c = 0; c < CH_COUNT; c++) {
+        cb_init(&st->cb[c]);
+        for (int w = 0; w < WIN_COUNT; w++) {
+            tw_init(&st->windows[c][w], WINDOW_SPAN_SEC[w]);
+        }
+    }
+    return st;
+}
+
+/**
+ * @brief Adds a sample to every time window of one channel.
+ */
+static void add_to_windows(time_window_t *channel_windows, float value, double now) {
+    for (int w = 0; w < WIN_COUNT; w++) {
+        tw_add(&channel_windows[w], value, now);
+    }
+}
+
+/**
+ * @brief Feeds one (filtered) sample into its channel's buffer, time windows,
+ *        live stream, adaptive controller and trend estimator.
+ */
+static void store_sample(sensor_state_t *state, int c, float value, double now, double wall_now,
+                         adaptive_channel_t *channel) {
+    cb_push(&state->cb[c], value);
+    add_to_windows(state->windows[c], value, wall_now);
+    stream_server_publish(&stream, c, value, (int64_t)(wall_now * 1e6));
+    adaptive_update(channel, value, now);
+    trend_add(&trends[c], value, now);
+}
+
+/**
+ * @brief --batch per-sample work: one direct BME280 burst read and the CO₂ read,
+ *        stored raw in the block. No compensation, filtering, printing or bus
+ *        worker hand-off, so the CPU goes back to sleep right away.
+ * @return 0 on success, -1 if the BME280 read failed (the sample is skipped)
+ */
+static int capture_sample(int fd, double now, double wall_now) {
+    bme280_raw_t raw;
+    if (bme280_read_raw(fd, &raw) != 0) {
+        return -1;
+    }
+    uint32_t k = block.count++;
+    block.adc_T[k] = raw.adc_T;
+    block.adc_P[k] = raw.adc_P;
+    block.adc_H[k] = raw.adc_H;
+    block.co2[k] = i2c_sensor_read(0x5A, SENSOR_CO2);
+    block.mono[k] = now;
+    block.wall[k] = wall_now;
+    return 0;
+}
+
+/**
+ * @brief --batch burst: compensates the whole block in one call, then filters
+ *        and stores every sample in capture order with its capture timestamps.
+ */
+static void process_block(sensor_state_t *state, const bme280_calib_t *calib,
+                          adaptive_channel_t *channels, uint32_t *samples_read) {
+    float temp[BATCH_MAX_SAMPLES], pres[BATCH_MAX_SAMPLES], hum[BATCH_MAX_SAMPLES];
+    bme280_compensate_batch(calib, block.adc_T, block.adc_P, block.adc_H, temp, pres, hum, block.count);
+
+    for (uint32_t k = 0; k < block.count; k++) {
+        float median_temp = apply_median_filter(temp[k], state->temp_filter_buf, WINDOW_SIZE,
+                                                &state->temp_index, &state->temp_count);
+        store_sample(state, CH_TEMP, median_temp, block.mono[k], block.wall[k], &channels[CH_TEMP]);
+        store_sample(state, CH_HUM, hum[k], block.mono[k], block.wall[k], &channels[CH_HUM]);
+        store_sample(state, CH_CO2, block.co2[k], block.mono[k], block.wall[k], &channels[CH_CO2]);
+    }
+    for (int c = 0; c < CH_COUNT; c++) {
+        samples_read[c] += block.count;
+    }
+
+    uint32_t last = block.count - 1;
+    printf("\n📦 Burst of %u samples (latest: %.2f °C, %.2f hPa, %.2f %%, %.2f ppm)\n",
+           block.count, temp[last], pres[last], hum[last], block.co2[last]);
+    block.count = 0;
+}
+
+/**
+ * @brief Computes statistics over the buffers, encodes the BLE payload, writes
+ *        payload.bin and prints the report. In adaptive mode the payload is
+ *        dropped unless a field moved past its delta or the heartbeat expired.
+ * @return 1 if a payload was published, 0 if it was suppressed
+ */
+static int publish_payload(sensor_state_t *state, const app_options_t *opts,
+                           send_on_delta_t *gate, double now, double wall_now) {
+    float buf_temp[BUFFER_SIZE], buf_hum[BUFFER_SIZE], buf_co2[BUFFER_SIZE];
+    uint8_t count_temp = cb_get_all(&state->cb[CH_TEMP], buf_temp);
+    uint8_t count_hum  = cb_get_all(&state->cb[CH_HUM],  buf_hum);
+    uint8_t count_co2  = cb_get_all(&state->cb[CH_CO2],  buf_co2);
+
+    stats_t stats_temp, stats_hum, stats_co2;
+    compute_statistics(buf_temp, count_temp, &stats_temp);
+    compute_statistics(buf_hum,  count_hum,  &stats_hum);
+    compute_statistics(buf_co2,  count_co2,  &stats_co2);
+    trend_fill_stats(&trends[CH_TEMP], &stats_temp);
+    trend_fill_stats(&trends[CH_HUM],  &stats_hum);
+    trend_fill_stats(&trends[CH_CO2],  &stats_co2);
+
+    // Prepare BLE advertising payload; in adaptive mode it is only
+    // published if a field moved past its delta or the heartbeat expired
+    uint8_t payload[BLE_PAYLOAD_TREND_SIZE];
+    size_t payload_len = opts->trend ? BLE_PAYLOAD_TREND_SIZE : BLE_PAYLOAD_SIZE;
+    encode_ble_stats_fields(payload, &stats_temp, &stats_hum, &stats_co2);
+    if (opts->trend) {
+        encode_ble_trend_fields(payload, &stats_temp, &stats_hum, &stats_co2);
+    }
+    if (opts->adaptive && !sod_should_publish(gate, payload, now)) {
+        return 0;
+    }
+    ble_encoder_header(&state->encoder, payload, time(NULL));
+    sod_mark_published(gate, payload, now);
+
+    // Write payload to file for external BLE advertiser to read
+    FILE *f = fopen("payload.bin", "wb");
+    if (f) {
+        fwrite(payload, sizeof(uint8_t), payload_len, f);
+        fclose(f);
+    }
+
+    // Print computed statistics
+    printf("📡 BLE Updated\n");
+    printf("📊 Temp → Mean: %.2f  Min: %.2f  Max: %.2f  Med: %.2f  Std: %.2f\n",
+        stats_temp.mean, stats_temp.min, stats_temp.max, stats_temp.median, stats_temp.std_dev);
+    printf("📊 Hum  → Mean: %.2f  Min: %.2f  Max: %.2f  Med: %.2f  Std: %.2f\n",
+        stats_hum.mean, stats_hum.min, stats_hum.max, stats_hum.median, stats_hum.std_dev);
+    printf("📊 CO₂  → Mean: %.2f  Min: %.2f  Max: %.2f  Med: %.2f  Std: %.2f\n",
+        stats_co2.mean, stats_co2.min, stats_co2.max, stats_co2.median, stats_co2.std_dev);
+    printf("📈 Trend → Temp: %+.2f °C/min (R² %.2f)  Hum: %+.2f %%/min (R² %.2f)  CO₂: %+.1f ppm/min (R² %.2f)\n",
+        stats_temp.slope, stats_temp.r2, stats_hum.slope, stats_hum.r2, stats_co2.slope, stats_co2.r2);
+    if (opts->holt) {
+        printf("📈 Holt  → Temp: %.2f (%+.2f/min)  Hum: %.2f (%+.2f/min)  CO₂: %.1f (%+.1f/min)\n",
+            stats_temp.holt_level, stats_temp.holt_slope, stats_hum.holt_level, stats_hum.holt_slope,
+            stats_co2.holt_level, stats_co2.holt_slope);
+    }
+    if (stats_co2.slope > CO2_RISE_ALERT_PPM_MIN && stats_co2.r2 > TREND_ALERT_MIN_R2) {
+        printf("🚨 CO₂ rising %.1f ppm/min — ventilation recommended\n", stats_co2.slope);
+    }
+
+    // Long-horizon percentiles from the bounded-memory sketches
+    for (int c = 0; c < CH_COUNT; c++) {
+        printf("🕒 %s p5/p50/p95/p99 →", CHANNEL_LABEL[c]);
+        for (int w = 0; w < WIN_COUNT; w++) {
+            window_stats_t ws;
+            tw_query(&state->windows[c][w], wall_now, &ws);
+            printf("  %s: %.2f/%.2f/%.2f/%.2f", WINDOW_LABEL[w], ws.p5, ws.p50, ws.p95, ws.p99);
+        }
+        printf("\n");
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
     signal(SIGINT, handle_sigint);
 
+    app_options_t opts;
+    parse_args(argc, argv, &opts);
+    if (opts.batch && opts.adaptive) {
+        printf("❌ --adaptive needs per-sample processing, ignored in --batch mode\n");
+        opts.adaptive = 0;
+    }
+    const rt_config_t rt = opts.rt;
+
+    i2c_sim_seed(opts.seed);
+    printf("🎲 Simulation seed: %llu\n", (unsigned long long)opts.seed);
+
     // Open I2C interface
     int fd = i2c_open(I2C_DEV);
     if (fd < 0) {
@@ -55,91 +403,221 @@ int main() {
 
     // Configure BME280 and read calibration data
     bme280_configure(fd);
-    uint16_t T1;
-    int16_t T2, T3;
-    if (bme280_read_calibration(fd, &T1, &T2, &T3) != 0) {
+    bme280_calib_t calib;
+    if (bme280_read_calibration_full(fd, &calib) != 0) {
         printf("❌ Failed to read calibration data.\n");
         i2c_close(fd);
         return 1;
     }
 
-    // Buffers for filtering and storage
-    float temp_filter_buf[WINDOW_SIZE] = {0};
-    uint8_t temp_index = 0, temp_count = 0;
+    // Periodic reads go through the bus worker so bus time overlaps with processing
+    if (i2c_bus_start(&bus, I2C_DEV) != 0) {
+        printf("❌ Failed to start I2C bus worker.\n");
+        i2c_close(fd);
+        return 1;
+    }
 
-    circular_buffer_t temp_cb, hum_cb, co2_cb;
-    cb_init(&temp_cb);
-    cb_init(&hum_cb);
-    cb_init(&co2_cb);
+    // Buffers for filtering and storage, resumed from the state file after a restart
+    sensor_state_t *state = attach_state(opts.state_path);
 
     int tick = 0;
 
+    // Live feed: socket I/O runs on its own thread, the loop only copies into a ring
+    if (opts.stream_path) {
+        if (stream_server_start(&stream, opts.stream_path) == 0) {
+            printf("📡 Streaming live samples on %s\n", opts.stream_path);
+        } else {
+            printf("❌ Failed to start stream server on %s\n", opts.stream_path);
+        }
+    }
+
+    // Real-time mode: all buffers above are static, mapped or on the stack, so locking memory
+    // now (and giving stdout a static buffer) keeps the loop free of page faults
+    // and heap allocations.
+    static char stdout_buf[BUFSIZ];
+    rt_latency_t latency;
+    rt_latency_init(&latency);
+    if (rt.enabled) {
+        setvbuf(stdout, stdout_buf, _IOLBF, sizeof(stdout_buf));
+        rt_lock_memory(RT_PREFAULT_STACK);
+        if (rt_apply_thread(pthread_self(), &rt) == 0) {
+            printf("⚡ Real-time mode: SCHED_FIFO prio=%d cpu=%d\n", rt.priority, rt.cpu);
+        }
+        // The loop blocks on bus completions, so the bus worker must not run
+        // below it (priority inversion against SCHED_OTHER load)
+        if (rt_apply_thread(bus.thread, &rt) != 0) {
+            printf("❌ Failed to apply real-time settings to the I2C bus worker\n");
+        }
+    }
+
+    // Batched mode: the capture wake-ups do almost nothing, so they may be
+    // deferred and merged with other timers (ignored for SCHED_FIFO threads)
+    if (opts.batch) {
+        prctl(PR_SET_TIMERSLACK, BATCH_TIMER_SLACK_NS);
+        printf("🔋 Batched mode: %d samples per burst\n", opts.batch);
+    }
+
+    // Absolute deadlines keep the period fixed regardless of processing time
+    struct timespec deadline, woke;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    double start_time = deadline.tv_sec + deadline.tv_nsec / 1e9;
+    double now = start_time;
+
+    // Adaptive sampling state and send-on-delta gate (gate also counts payloads in fixed mode)
+    adaptive_channel_t channels[CH_COUNT];
+    for (int c = 0; c < CH_COUNT; c++) {
+        adaptive_init(&channels[c], &ADAPTIVE_CFG[c], start_time);
+    }
+    send_on_delta_t gate;
+    sod_init(&gate, SOD_FIELD_DELTA, SOD_HEARTBEAT_SEC);
+    uint32_t samples_read[CH_COUNT] = {0};
+
+    for (int c = 0; c < CH_COUNT; c++) {
+        trend_init(&trends[c], opts.holt ? HOLT_ALPHA : 0.0f, HOLT_BETA);
+    }
+
+    // Wake-up and CPU accounting, to compare --batch against per-sample processing
+    struct rusage usage_start, usage_end;
+    getrusage(RUSAGE_SELF, &usage_start);
+    uint32_t wakeups = 0;
+
     while (keep_running) {
-        // Read raw temperature value from BME280
-        int32_t raw_temp;
-        if (bme280_read_raw_temp(fd, &raw_temp) != 0) {
-            printf("❌ Failed to read raw temperature.\n");
-            sleep(MEASUREMENT_INTERVAL_SEC);
+        // Seal everything the previous iteration changed before going to sleep
+        // (in --batch mode only bursts change the state, so they commit themselves)
+        if (!opts.batch) {
+            persist_commit(&state_file, wall_time());
+        }
+
+        if (rt_sleep_until(&deadline) != 0) {
+            continue;  // Interrupted (e.g. SIGINT) → re-check keep_running
+        }
+        wakeups++;
+        clock_gettime(CLOCK_MONOTONIC, &woke);
+        rt_latency_record(&latency, &deadline, &woke);
+        rt_timespec_add_ns(&deadline, (int64_t)MEASUREMENT_INTERVAL_SEC * 1000000000LL);
+        now = woke.tv_sec + woke.tv_nsec / 1e9;
+
+        // Time windows use wall-clock time so they are independent of the sample rate
+        double wall_now = wall_time();
+
+        // Batched mode: capture raw data only; the K-th capture, right at the
+        // payload deadline, runs compensation, filtering, stats and encoding for the block
+        if (opts.batch) {
+            if (capture_sample(fd, now, wall_now) != 0) {
+                printf("❌ Failed to read raw sensor data.\n");
+                continue;
+            }
+            if (block.count == (uint32_t)opts.batch) {
+                process_block(state, &calib, channels, samples_read);
+                publish_payload(state, &opts, &gate, now, wall_now);
+                persist_commit(&state_file, wall_time());
+            }
             continue;
         }
 
-        // Convert raw temperature using calibration values
-        float temp = bme280_calibrate_temp(raw_temp, T1, T2, T3);
+        // In adaptive mode, a channel is only read when its own period has elapsed
+        bool due[CH_COUNT];
+        for (int c = 0; c < CH_COUNT; c++) {
+            due[c] = !opts.adaptive || adaptive_due(&channels[c], now);
+        }
 
-        // Read simulated humidity and CO₂ values from mock I2C devices
-        float hum  = i2c_sensor_read(0x76, SENSOR_HUMIDITY);
-        float co2  = i2c_sensor_read(0x5A, SENSOR_CO2);
+        float temp = 0.0f, hum = 0.0f, co2 = 0.0f;
+        bme280_reading_t reading = {0};
 
-        // Apply moving median filter to temperature
-        float median_temp = apply_median_filter(temp, temp_filter_buf, WINDOW_SIZE, &temp_index, &temp_count);
+        // Queue this tick's device reads and hand them to the bus worker, which
+        // runs them while this thread handles the simulated channels. The BME280
+        // is the only real device on the bus, so each batch holds a single read
+        bool bme_due = due[CH_TEMP] || due[CH_HUM];
+        if (bme_due) {
+            i2c_bus_submit(&bus, REQ_BME280_DATA, BME280_ADDR, BME280_REG_DATA, BME280_DATA_LEN);
+            i2c_bus_flush(&bus);
+        }
 
-        // Store filtered values in circular buffers
-        cb_push(&temp_cb, median_temp);
-        cb_push(&hum_cb, hum);
-        cb_push(&co2_cb, co2);
+        // Read simulated CO₂ value from mock I2C device
+        if (due[CH_CO2]) {
+            co2 = i2c_sensor_read(0x5A, SENSOR_CO2);
+            store_sample(state, CH_CO2, co2, now, wall_now, &channels[CH_CO2]);
+            samples_read[CH_CO2]++;
+        }
+
+        if (bme_due) {
+            // Collect the BME280 completion (raw temperature, pressure and humidity)
+            i2c_request_t done;
+            if (i2c_bus_wait(&bus, &done) != 0 || done.status != 0) {
+                printf("❌ Failed to read raw sensor data.\n");
+                continue;
+            }
+            bme280_raw_t raw;
+            bme280_parse_raw(done.data, &raw);
+
+            // Compensate all channels; temperature's t_fine feeds pressure and humidity
+            bme280_compensate(&raw, &calib, &reading);
+        }
+
+        if (due[CH_TEMP]) {
+            temp = reading.temperature;
+
+            // Apply moving median filter to temperature and store it
+            float median_temp = apply_median_filter(temp, state->temp_filter_buf, WINDOW_SIZE,
+                                                    &state->temp_index, &state->temp_count);
+            store_sample(state, CH_TEMP, median_temp, now, wall_now, &channels[CH_TEMP]);
+            samples_read[CH_TEMP]++;
+        }
+
+        if (due[CH_HUM]) {
+            hum = reading.humidity;
+            store_sample(state, CH_HUM, hum, now, wall_now, &channels[CH_HUM]);
+            samples_read[CH_HUM]++;
+        }
 
         // Print raw values
-        printf("\n📥 New Measurement\n");
-        printf("🌡️  Temperature : %.2f °C\n", temp);
-        printf("💧 Humidity    : %.2f %%\n", hum);
-        printf("🫁 CO₂         : %.2f ppm\n", co2);
+        if (due[CH_TEMP] || due[CH_HUM] || due[CH_CO2]) {
+            printf("\n📥 New Measurement\n");
+        }
+        if (due[CH_TEMP]) printf("🌡️  Temperature : %.2f °C\n", temp);
+        if (due[CH_TEMP]) printf("🧭 Pressure    : %.2f hPa\n", reading.pressure);
+        if (due[CH_HUM])  printf("💧 Humidity    : %.2f %%\n", hum);
+        if (due[CH_CO2])  printf("🫁 CO₂         : %.2f ppm\n", co2);
 
         // Every BLE_UPDATE_INTERVAL_SEC seconds, update BLE packet
         if (++tick % BLE_UPDATE_INTERVAL_SEC == 0) {
-            float buf_temp[BUFFER_SIZE], buf_hum[BUFFER_SIZE], buf_co2[BUFFER_SIZE];
-            uint8_t count_temp = cb_get_all(&temp_cb, buf_temp);
-            uint8_t count_hum  = cb_get_all(&hum_cb, buf_hum);
-            uint8_t count_co2  = cb_get_all(&co2_cb, buf_co2);
-
-            stats_t stats_temp, stats_hum, stats_co2;
-            compute_statistics(buf_temp, count_temp, &stats_temp);
-            compute_statistics(buf_hum,  count_hum,  &stats_hum);
-            compute_statistics(buf_co2,  count_co2,  &stats_co2);
-
-            // Prepare BLE advertising payload
-            uint8_t payload[BLE_PAYLOAD_SIZE];
-            encode_ble_advertising_data(payload, &stats_temp, &stats_hum, &stats_co2);
-
-            // Write payload to file for external BLE advertiser to read
-            FILE *f = fopen("payload.bin", "wb");
-            if (f) {
-                fwrite(payload, sizeof(uint8_t), BLE_PAYLOAD_SIZE, f);
-                fclose(f);
-            }
-
-            // Print computed statistics
-            printf("📡 BLE Updated\n");
-            printf("📊 Temp → Mean: %.2f  Min: %.2f  Max: %.2f  Med: %.2f  Std: %.2f\n",
-                stats_temp.mean, stats_temp.min, stats_temp.max, stats_temp.median, stats_temp.std_dev);
-            printf("📊 Hum  → Mean: %.2f  Min: %.2f  Max: %.2f  Med: %.2f  Std: %.2f\n",
-                stats_hum.mean, stats_hum.min, stats_hum.max, stats_hum.median, stats_hum.std_dev);
-            printf("📊 CO₂  → Mean: %.2f  Min: %.2f  Max: %.2f  Med: %.2f  Std: %.2f\n",
-                stats_co2.mean, stats_co2.min, stats_co2.max, stats_co2.median, stats_co2.std_dev);
+            publish_payload(state, &opts, &gate, now, wall_now);
         }
+    }
+
+    // Effective sampling / publishing rates, to quantify --adaptive savings
+    double elapsed = now - start_time;
+    if (elapsed > 0.0) {
+        printf("📉 Samples/s → Temp: %.3f  Hum: %.3f  CO₂: %.3f   Payloads/s: %.3f (%u of %u evaluated)\n",
+               samples_read[CH_TEMP] / elapsed, samples_read[CH_HUM] / elapsed,
+               samples_read[CH_CO2] / elapsed, gate.published / elapsed,
+               gate.published, opts.adaptive ? gate.evaluated : gate.published);
+
+        getrusage(RUSAGE_SELF, &usage_end);
+        double cpu = (usage_end.ru_utime.tv_sec - usage_start.ru_utime.tv_sec) +
+                     (usage_end.ru_utime.tv_usec - usage_start.ru_utime.tv_usec) / 1e6 +
+                     (usage_end.ru_stime.tv_sec - usage_start.ru_stime.tv_sec) +
+                     (usage_end.ru_stime.tv_usec - usage_start.ru_stime.tv_usec) / 1e6;
+        long switches = (usage_end.ru_nvcsw - usage_start.ru_nvcsw) +
+                        (usage_end.ru_nivcsw - usage_start.ru_nivcsw);
+        printf("⏰ Wake-ups/s → loop: %.3f  all threads: %.3f   CPU: %.3f ms per payload (%.1f ms total, %s)\n",
+               wakeups / elapsed, switches / elapsed,
+               gate.published ? cpu * 1e3 / gate.published : 0.0, cpu * 1e3,
+               opts.batch ? "batched" : "per-sample");
+    }
 
-        sleep(MEASUREMENT_INTERVAL_SEC);
+    rt_latency_print(&latency, "Acquisition loop");
+    if (rt.enabled && rt_latency_write_histogram(&latency, RT_HIST_FILE) == 0) {
+        printf("📈 Latency histogram written to %s\n", RT_HIST_FILE);
     }
 
+    // Join the worker first so its counters are final
+    i2c_bus_stop(&bus);
+    printf("🔌 I2C bus: %u reads in %u transfers, %u failed%s\n", bus.requests, bus.transfers, bus.failures,
+           bus.single_read ? " (adapter takes one read per transfer)" : "");
+    persist_commit(&state_file, wall_time());
+    persist_close(&state_file);
+    stream_server_stop(&stream);
     i2c_close(fd);
     printf("✅ Program exited successfully.\n");
     return 0;
@@ -2,6 +2,47 @@
 #include <string.h>  // for memcpy
 #include <stdlib.h>  // for qsort
 
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+/*
+ * Median-selection networks for the fixed window sizes. Each entry is a
+ * compare-exchange on two slots:
+ *   CX(i, j)  p[i] = min, p[j] = max
+ *   MN(i, j)  p[i] = min only (p[j] is not read again)
+ *   MX(i, j)  p[j] = max only (p[i] is not read again)
+ * The median ends up in p[N / 2]. Sizes 3-9 are the well-known minimal median
+ * networks, 11 is Batcher's odd-even merge sort pruned to the middle output;
+ * all of them were checked exhaustively with the 0-1 principle. Every step is
+ * a plain min/max, so there are no data-dependent branches and the same list
+ * expands to scalar or vector code.
+ */
+#define MEDIAN3_NETWORK(CX, MN, MX) \
+    CX(0,1) MN(1,2) MX(0,1)
+
+#define MEDIAN5_NETWORK(CX, MN, MX) \
+    CX(0,1) CX(3,4) MX(0,3) MN(1,4) CX(1,2) MN(2,3) MX(1,2)
+
+#define MEDIAN7_NETWORK(CX, MN, MX) \
+    CX(0,5) CX(0,3) CX(1,6) CX(2,4) MX(0,1) CX(3,5) CX(2,6) MX(2,3) \
+    MN(3,6) MN(4,5) CX(1,4) MX(1,3) MN(3,4)
+
+#define MEDIAN9_NETWORK(CX, MN, MX) \
+    CX(1,2) CX(4,5) CX(7,8) CX(0,1) CX(3,4) CX(6,7) CX(1,2) CX(4,5) \
+    CX(7,8) MX(0,3) MN(5,8) CX(4,7) MX(3,6) MX(1,4) MN(2,5) MN(4,7) \
+    CX(4,2) MX(6,4) MN(4,2)
+
+#define MEDIAN11_NETWORK(CX, MN, MX) \
+    CX(0,1) CX(2,3) CX(4,5) CX(6,7) CX(8,9) CX(0,2) CX(1,3) CX(4,6) \
+    CX(5,7) CX(8,10) CX(1,2) CX(5,6) CX(9,10) CX(0,4) CX(1,5) CX(2,6) \
+    MN(3,7) CX(2,4) CX(3,5) CX(1,2) CX(3,4) CX(5,6) CX(9,10) MX(0,8) \
+    MX(1,9) MX(2,10) MX(4,8) MN(5,9) MN(6,10) MX(3,5) MN(6,8) MN(5,6)
+
+#define FOR_EACH_NETWORK_SIZE(X) X(3) X(5) X(7) X(9) X(11)
+
 /**
  * @brief Comparison function for qsort, used to sort float values.
  */
@@ -11,11 +52,45 @@ static int compare_floats(const void *a, const void *b) {
     return (fa > fb) - (fa < fb);
 }
 
+/**
+ * @brief Median of any number of samples by sorting a copy.
+ *        Used while a window is still filling up and for sizes without a network.
+ */
+static float median_generic(const float *samples, uint8_t count) {
+    float sorted[MAX_WINDOW_SIZE];
+    memcpy(sorted, samples, sizeof(float) * count);
+    qsort(sorted, count, sizeof(float), compare_floats);
+
+    if (count % 2 == 1) {
+        return sorted[count / 2];
+    } else {
+        return (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0f;
+    }
+}
+
+// Scalar compare-exchange; the ternaries compile to minss/maxss (fminnm/fcsel on ARM)
+#define S_CX(i, j) { float lo_ = p[i] < p[j] ? p[i] : p[j]; \
+                     p[j] = p[i] < p[j] ? p[j] : p[i]; p[i] = lo_; }
+#define S_MN(i, j) { p[i] = p[i] < p[j] ? p[i] : p[j]; }
+#define S_MX(i, j) { p[j] = p[i] < p[j] ? p[j] : p[i]; }
+
+// median_3() .. median_11(): slot order does not matter for a median, so the
+// circular buffer is used as is, without unrolling it
+#define DEFINE_SCALAR_KERNEL(N)                                 \
+    static float median_##N(const float *w) {                  \
+        float p[N];                                             \
+        for (int k = 0; k < N; k++) p[k] = w[k];                \
+        MEDIAN##N##_NETWORK(S_CX, S_MN, S_MX)                   \
+        return p[N / 2];                                        \
+    }
+FOR_EACH_NETWORK_SIZE(DEFINE_SCALAR_KERNEL)
+
 /**
  * @brief Applies a moving median filter to a stream of float values.
  * 
- * The filter stores the latest N samples in a circular buffer, sorts them, and returns the median.
- * This helps to remove spikes and noise in sensor readings.
+ * The filter stores the latest N samples in a circular buffer and returns their median.
+ * This helps to remove spikes and noise in sensor readings. Once the window is full,
+ * sizes 3, 5, 7, 9 and 11 use a branchless sorting network instead of qsort.
  * 
  * @param new_sample  New incoming data point
  * @param buffer      Circular buffer holding past values
@@ -33,15 +108,114 @@ float apply_median_filter(float new_sample, float *buffer, uint8_t window_size,
     if (*count < window_size)
         (*count)++;
 
-    // Create a sorted copy of the current buffer contents
-    float sorted[MAX_WINDOW_SIZE];
-    memcpy(sorted, buffer, sizeof(float) * (*count));
-    qsort(sorted, *count, sizeof(float), compare_floats);
+    if (*count == window_size) {
+        switch (window_size) {
+#define CASE_KERNEL(N) case N: return median_##N(buffer);
+            FOR_EACH_NETWORK_SIZE(CASE_KERNEL)
+#undef CASE_KERNEL
+            default: break;
+        }
+    }
+    return median_generic(buffer, *count);
+}
 
-    // Return median value
-    if (*count % 2 == 1) {
-        return sorted[*count / 2];
-    } else {
-        return (sorted[*count / 2 - 1] + sorted[*count / 2]) / 2.0f;
+/* 4-lane vector used by the median bank */
+#if defined(__ARM_NEON)
+typedef float32x4_t mf_vec_t;
+#define V_LOAD(ptr)      vld1q_f32(ptr)
+#define V_STORE(ptr, v)  vst1q_f32(ptr, v)
+#define V_MIN(a, b)      vminq_f32(a, b)
+#define V_MAX(a, b)      vmaxq_f32(a, b)
+#elif defined(__SSE__)
+typedef __m128 mf_vec_t;
+#define V_LOAD(ptr)      _mm_load_ps(ptr)
+#define V_STORE(ptr, v)  _mm_store_ps(ptr, v)
+#define V_MIN(a, b)      _mm_min_ps(a, b)
+#define V_MAX(a, b)      _mm_max_ps(a, b)
+#else
+// Portable fallback; the compiler can still auto-vectorize these loops
+typedef struct { float f[4]; } mf_vec_t;
+static inline mf_vec_t V_LOAD(const float *ptr) { mf_vec_t v; memcpy(v.f, ptr, sizeof(v.f)); return v; }
+static inline void V_STORE(float *ptr, mf_vec_t v) { memcpy(ptr, v.f, sizeof(v.f)); }
+static inline mf_vec_t V_MIN(mf_vec_t a, mf_vec_t b) {
+    for (int l = 0; l < 4; l++) a.f[l] = a.f[l] < b.f[l] ? a.f[l] : b.f[l];
+    return a;
+}
+static inline mf_vec_t V_MAX(mf_vec_t a, mf_vec_t b) {
+    for (int l = 0; l < 4; l++) a.f[l] = a.f[l] < b.f[l] ? b.f[l] : a.f[l];
+    return a;
+}
+#endif
+
+#define V_CX(i, j) { mf_vec_t lo_ = V_MIN(v[i], v[j]); v[j] = V_MAX(v[i], v[j]); v[i] = lo_; }
+#define V_MN(i, j) { v[i] = V_MIN(v[i], v[j]); }
+#define V_MX(i, j) { v[j] = V_MAX(v[i], v[j]); }
+
+// bank_median_3() .. bank_median_11(): one network pass per group of 4 lanes.
+// Rows are MF_BANK_LANES wide and 16-byte aligned, so a partial last group
+// reads valid (unused) lanes and writes them to the padded result.
+#define DEFINE_BANK_KERNEL(N)                                           \
+    static void bank_median_##N(const median_bank_t *b, float *res) {  \
+        for (int g = 0; g < b->lanes; g += 4) {                         \
+            mf_vec_t v[N];                                              \
+            for (int k = 0; k < N; k++) v[k] = V_LOAD(&b->window[k][g]); \
+            MEDIAN##N##_NETWORK(V_CX, V_MN, V_MX)                       \
+            V_STORE(&res[g], v[N / 2]);                                 \
+        }                                                               \
+    }
+FOR_EACH_NETWORK_SIZE(DEFINE_BANK_KERNEL)
+
+/**
+ * @brief Prepares a median bank that filters several streams in lockstep.
+ * @param bank        Bank to initialize
+ * @param window_size Median window size (1..MAX_WINDOW_SIZE)
+ * @param lanes       Number of streams (1..MF_BANK_LANES)
+ * @return 0 on success, -1 on invalid sizes
+ */
+int median_bank_init(median_bank_t *bank, uint8_t window_size, uint8_t lanes) {
+    if (window_size == 0 || window_size > MAX_WINDOW_SIZE || lanes == 0 || lanes > MF_BANK_LANES) {
+        return -1;
+    }
+    memset(bank, 0, sizeof(*bank));
+    bank->size = window_size;
+    bank->lanes = lanes;
+    return 0;
+}
+
+/**
+ * @brief Pushes one sample per lane and returns each lane's moving median.
+ *
+ * Once the window is full, sizes 3, 5, 7, 9 and 11 run the same sorting
+ * networks as apply_median_filter() on 4 lanes per instruction (NEON or SSE).
+ *
+ * @param bank    Bank state
+ * @param samples bank->lanes new samples, one per lane
+ * @param out     bank->lanes medians, one per lane (may alias samples)
+ */
+void median_bank_apply(median_bank_t *bank, const float *samples, float *out) {
+    memcpy(bank->window[bank->index], samples, sizeof(float) * bank->lanes);
+    bank->index = (bank->index + 1) % bank->size;
+    if (bank->count < bank->size)
+        bank->count++;
+
+    float res[MF_BANK_LANES] __attribute__((aligned(16)));
+
+    if (bank->count == bank->size) {
+        switch (bank->size) {
+#define CASE_BANK_KERNEL(N) case N: bank_median_##N(bank, res); \
+                                    memcpy(out, res, sizeof(float) * bank->lanes); return;
+            FOR_EACH_NETWORK_SIZE(CASE_BANK_KERNEL)
+#undef CASE_BANK_KERNEL
+            default: break;
+        }
+    }
+
+    // Warm-up or a size without a network: gather each lane and sort it
+    for (uint8_t lane = 0; lane < bank->lanes; lane++) {
+        float column[MAX_WINDOW_SIZE];
+        for (uint8_t k = 0; k < bank->count; k++) {
+            column[k] = bank->window[k][lane];
+        }
+        out[lane] = median_generic(column, bank->count);
     }
 }
@@ -0,0 +1,251 @@
+#include "quantile.h"
+#include <math.h>   // for asinf, floor, sqrt
+#include <string.h> // for memset
+
+#define PI_F 3.14159265f
+#define MERGE_MAX (2 * (QSKETCH_CAPACITY + QSKETCH_BUFFER))
+
+/**
+ * @brief t-digest k1 scale function. Centroids may span at most 1 unit of k,
+ *        which keeps them small near the tails (p1/p99) and large near p50.
+ */
+static inline float scale_k(float q) {
+    return (QSKETCH_COMPRESSION / (2.0f * PI_F)) * asinf(2.0f * q - 1.0f);
+}
+
+/**
+ * @brief Sorts (mean, weight) pairs by mean. Inputs are short and mostly
+ *        sorted already, so insertion sort beats qsort here.
+ */
+static void sort_centroids(float *mean, float *weight, int n) {
+    for (int i = 1; i < n; i++) {
+        float m = mean[i], w = weight[i];
+        int j = i - 1;
+        while (j >= 0 && mean[j] > m) {
+            mean[j + 1] = mean[j];
+            weight[j + 1] = weight[j];
+            j--;
+        }
+        mean[j + 1] = m;
+        weight[j + 1] = w;
+    }
+}
+
+/**
+ * @brief Merges adjacent centroids under the k1 size limit and stores the result in sk.
+ * @param sk     Sketch receiving the compressed centroids
+ * @param mean   Centroid means (will be sorted)
+ * @param weight Centroid weights
+ * @param n      Number of input centroids
+ */
+static void compress(qsketch_t *sk, float *mean, float *weight, int n) {
+    sort_centroids(mean, weight, n);
+
+    float total = 0.0f;
+    for (int i = 0; i < n; i++) total += weight[i];
+
+    int out = 0;
+    float cur_mean = mean[0], cur_weight = weight[0];
+    float weight_before = 0.0f;
+    float k_left = scale_k(0.0f);
+
+    for (int i = 1; i < n; i++) {
+        float q_right = (weight_before + cur_weight + weight[i]) / total;
+        // Last slot is reserved so the final centroid always fits
+        if (scale_k(q_right) - k_left <= 1.0f || out >= QSKETCH_CAPACITY - 1) {
+            cur_weight += weight[i];
+            cur_mean += (mean[i] - cur_mean) * weight[i] / cur_weight;
+        } else {
+            sk->mean[out] = cur_mean;
+            sk->weight[out] = cur_weight;
+            out++;
+            weight_before += cur_weight;
+            k_left = scale_k(weight_before / total);
+            cur_mean = mean[i];
+            cur_weight = weight[i];
+        }
+    }
+    sk->mean[out] = cur_mean;
+    sk->weight[out] = cur_weight;
+    sk->centroids = (uint8_t)(out + 1);
+}
+
+/**
+ * @brief Folds buffered raw samples into the centroid list.
+ */
+static void flush_buffer(qsketch_t *sk) {
+    if (sk->buffered == 0) return;
+
+    float mean[MERGE_MAX], weight[MERGE_MAX];
+    int n = 0;
+    for (int i = 0; i < sk->centroids; i++, n++) {
+        mean[n] = sk->mean[i];
+        weight[n] = sk->weight[i];
+    }
+    for (int i = 0; i < sk->buffered; i++, n++) {
+        mean[n] = sk->buffer[i];
+        weight[n] = 1.0f;
+    }
+    sk->buffered = 0;
+    compress(sk, mean, weight, n);
+}
+
+/**
+ * @brief Initializes an empty sketch.
+ */
+void qsketch_init(qsketch_t *sk) {
+    memset(sk, 0, sizeof(*sk));
+    sk->min = INFINITY;
+    sk->max = -INFINITY;
+}
+
+/**
+ * @brief Adds one sample. Amortized O(1): samples are buffered and
+ *        compressed QSKETCH_BUFFER at a time.
+ */
+void qsketch_add(qsketch_t *sk, float value) {
+    if (value < sk->min) sk->min = value;
+    if (value > sk->max) sk->max = value;
+    sk->count++;
+
+    sk->buffer[sk->buffered++] = value;
+    if (sk->buffered == QSKETCH_BUFFER) {
+        flush_buffer(sk);
+    }
+}
+
+/**
+ * @brief Merges src into dst. dst then summarizes both sample sets.
+ */
+void qsketch_merge(qsketch_t *dst, const qsketch_t *src) {
+    if (src->count == 0) return;
+
+    float mean[MERGE_MAX], weight[MERGE_MAX];
+    int n = 0;
+    for (int i = 0; i < dst->centroids; i++, n++) { mean[n] = dst->mean[i]; weight[n] = dst->weight[i]; }
+    for (int i = 0; i < dst->buffered; i++, n++)  { mean[n] = dst->buffer[i]; weight[n] = 1.0f; }
+    for (int i = 0; i < src->centroids; i++, n++) { mean[n] = src->mean[i]; weight[n] = src->weight[i]; }
+    for (int i = 0; i < src->buffered; i++, n++)  { mean[n] = src->buffer[i]; weight[n] = 1.0f; }
+
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    dst->count += src->count;
+    dst->buffered = 0;
+    compress(dst, mean, weight, n);
+}
+
+/**
+ * @brief Estimates the q-quantile (0 ≤ q ≤ 1) by interpolating between centroid centers.
+ * @param sk Sketch (pending samples are flushed first)
+ * @param q  Quantile, e.g. 0.95 for p95
+ * @return Estimated value, or NAN if the sketch is empty
+ */
+float qsketch_quantile(qsketch_t *sk, float q) {
+    if (sk->count == 0) return NAN;
+    flush_buffer(sk);
+
+    if (sk->centroids == 1) return sk->mean[0];
+
+    float total = 0.0f;
+    for (int i = 0; i < sk->centroids; i++) total += sk->weight[i];
+    float target = q * total;
+
+    // Before the first centroid center: interpolate from the exact minimum
+    float first_center = sk->weight[0] / 2.0f;
+    if (target <= first_center) {
+        return sk->min + (sk->mean[0] - sk->min) * (target / first_center);
+    }
+
+    float cum = 0.0f;
+    for (int i = 0; i < sk->centroids - 1; i++) {
+        float center = cum + sk->weight[i] / 2.0f;
+        float next_center = cum + sk->weight[i] + sk->weight[i + 1] / 2.0f;
+        if (target <= next_center) {
+            float t = (target - center) / (next_center - center);
+            return sk->mean[i] + (sk->mean[i + 1] - sk->mean[i]) * t;
+        }
+        cum += sk->weight[i];
+    }
+
+    // After the last centroid center: interpolate to the exact maximum
+    int last = sk->centroids - 1;
+    float last_center = total - sk->weight[last] / 2.0f;
+    float t = (target - last_center) / (total - last_center);
+    return sk->mean[last] + (sk->max - sk->mean[last]) * t;
+}
+
+/**
+ * @brief Initializes a time window of the given length, split into TW_PANES panes.
+ *        Memory use is fixed regardless of sample rate or window length.
+ * @param tw       Window to initialize
+ * @param window_s Window length in seconds (e.g. 60, 900, 86400)
+ */
+void tw_init(time_window_t *tw, float window_s) {
+    tw->window_s = window_s;
+    tw->pane_s = window_s / TW_PANES;
+    for (int i = 0; i < TW_SLOTS; i++) {
+        tw->panes[i].id = -1;
+    }
+}
+
+/**
+ * @brief Adds a sample at time now. Panes that have aged out of the window
+ *        are recycled the first time their slot is reused.
+ */
+void tw_add(time_window_t *tw, float value, double now) {
+    int64_t id = (int64_t)floor(now / tw->pane_s);
+    tw_pane_t *pane = &tw->panes[id % TW_SLOTS];
+
+    if (pane->id != id) {
+        pane->id = id;
+        qsketch_init(&pane->sketch);
+        pane->sum = 0.0;
+        pane->sum_sq = 0.0;
+    }
+
+    qsketch_add(&pane->sketch, value);
+    pane->sum += value;
+    pane->sum_sq += (double)value * value;
+}
+
+/**
+ * @brief Computes statistics over the panes covering the last window_s seconds.
+ *        The current, partly filled pane is read together with the TW_PANES full
+ *        panes before it, so the whole nominal window is always covered. The
+ *        oldest pane can add up to pane_s of extra history.
+ *        Percentiles come from merging the pane sketches, so the cost depends only
+ *        on TW_SLOTS and QSKETCH_CAPACITY, not on how many samples were seen.
+ * @param tw  Window
+ * @param now Current time in seconds (same clock as tw_add)
+ * @param out Result; out->count is 0 if the window is empty
+ */
+void tw_query(const time_window_t *tw, double now, window_stats_t *out) {
+    int64_t current = (int64_t)floor(now / tw->pane_s);
+
+    qsketch_t merged;
+    qsketch_init(&merged);
+    double sum = 0.0, sum_sq = 0.0;
+
+    for (int i = 0; i < TW_SLOTS; i++) {
+        const tw_pane_t *pane = &tw->panes[i];
+        if (pane->id < 0 || pane->id < current - TW_PANES || pane->id > current) continue;
+        qsketch_merge(&merged, &pane->sketch);
+        sum += pane->sum;
+        sum_sq += pane->sum_sq;
+    }
+
+    memset(out, 0, sizeof(*out));
+    out->count = merged.count;
+    if (merged.count == 0) return;
+
+    double mean = sum / merged.count;
+    double var = sum_sq / merged.count - mean * mean;
+    out->mean = (float)mean;
+    out->std_dev = (float)sqrt(var > 0.0 ? var : 0.0);
+    out->min = merged.min;
+    out->max = merged.max;
+    out->p5  = qsketch_quantile(&merged, 0.05f);
+    out->p50 = qsketch_quantile(&merged, 0.50f);
+    out->p95 = qsketch_quantile(&merged, 0.95f);
+    out->p99 = qsketch_quantile(&merged, 0.99f);
+}
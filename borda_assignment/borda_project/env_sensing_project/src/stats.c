@@ -23,6 +23,10 @@ static int compare_floats(const void *a, const void *b) {
 void compute_statistics(const float *data, uint8_t count, stats_t *result) {
     if (count == 0) return;
 
+    // Trend fields come from the incremental estimator, not from a rescan
+    result->slope = result->intercept = result->r2 = 0.0f;
+    result->holt_level = result->holt_slope = 0.0f;
+
     float sum = 0.0f;
     result->min = data[0];
     result->max = data[0];
@@ -45,7 +49,7 @@ void compute_statistics(const float *data, uint8_t count, stats_t *result) {
     result->std_dev = sqrtf(variance / count);
 
     // Copy and sort data to compute median
-    float sorted[32];  // Maximum expected buffer size
+    float sorted[UINT8_MAX];  // count is a uint8_t, so this always fits
     memcpy(sorted, data, sizeof(float) * count);
     qsort(sorted, count, sizeof(float), compare_floats);
 
@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "stream_server.h"
+
+static const char *CHANNEL_NAMES[] = { "Temp", "Hum", "CO2" };
+
+/**
+ * @brief Minimal live-feed subscriber for env_sensor --stream.
+ *        Usage: stream_client [path] [channel_mask] [decimation] [policy]
+ *        policy: 0 = drop oldest, 1 = drop newest, 2 = disconnect
+ */
+int main(int argc, char *argv[]) {
+    const char *path = argc > 1 ? argv[1] : STREAM_DEFAULT_PATH;
+
+    stream_subscribe_t sub = {
+        .magic = STREAM_MAGIC,
+        .channel_mask = argc > 2 ? (uint8_t)strtoul(argv[2], NULL, 0) : 0xFF,
+        .decimation = argc > 3 ? (uint16_t)atoi(argv[3]) : 1,
+        .policy = argc > 4 ? (uint8_t)atoi(argv[4]) : STREAM_DROP_OLDEST
+    };
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        perror("Failed to connect to stream socket");
+        return 1;
+    }
+
+    if (send(fd, &sub, sizeof(sub), 0) != (ssize_t)sizeof(sub)) {
+        perror("Failed to subscribe");
+        close(fd);
+        return 1;
+    }
+    printf("📡 Subscribed to %s (mask=0x%02X, decimation=%u)\n", path, sub.channel_mask, sub.decimation);
+
+    struct {
+        stream_frame_header_t hdr;
+        stream_sample_t samples[STREAM_MAX_BATCH];
+    } frame;
+
+    ssize_t n;
+    while ((n = recv(fd, &frame, sizeof(frame), 0)) > 0) {
+        if ((size_t)n < sizeof(frame.hdr) || frame.hdr.magic != STREAM_MAGIC) continue;
+
+        if (frame.hdr.dropped) {
+            printf("⚠️  %u samples dropped (slow client)\n", frame.hdr.dropped);
+        }
+        for (int i = 0; i < frame.hdr.count; i++) {
+            const stream_sample_t *s = &frame.samples[i];
+            const char *name = s->channel < 3 ? CHANNEL_NAMES[s->channel] : "?";
+            printf("[%lld.%06lld] #%u %-4s = %.2f\n",
+                   (long long)(s->timestamp_us / 1000000), (long long)(s->timestamp_us % 1000000),
+                   s->seq, name, s->value);
+        }
+        fflush(stdout);
+    }
+
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,319 @@
+#define _GNU_SOURCE  // for accept4
+#include "stream_server.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+static double monotonic_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Wakes the server thread out of poll(). The eventfd counter only
+ *        accumulates, so repeated signals before the thread runs cost one wakeup.
+ */
+static void wake_server(stream_server_t *srv) {
+    uint64_t one = 1;
+    ssize_t n = write(srv->wake_fd, &one, sizeof(one));
+    (void)n;  // EAGAIN only if the counter is saturated, which still wakes the thread
+}
+
+/**
+ * @brief Closes a subscriber connection and frees its slot.
+ */
+static void drop_subscriber(stream_subscriber_t *sub) {
+    close(sub->fd);
+    sub->fd = -1;
+    sub->subscribed = 0;
+}
+
+/**
+ * @brief Accepts a pending connection into a free slot (or refuses it if all are taken).
+ */
+static void accept_subscriber(stream_server_t *srv) {
+    int fd = accept4(srv->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;
+
+    for (int i = 0; i < STREAM_MAX_SUBSCRIBERS; i++) {
+        stream_subscriber_t *sub = &srv->subs[i];
+        if (sub->fd < 0) {
+            memset(sub, 0, sizeof(*sub));
+            sub->fd = fd;
+            stream_ring_init(&sub->queue);
+            return;
+        }
+    }
+    close(fd);  // No free slot
+}
+
+/**
+ * @brief Reads the one-time subscribe message; any further input or EOF closes the client.
+ */
+static void read_subscriber(stream_subscriber_t *sub) {
+    stream_subscribe_t msg;
+    ssize_t n = recv(sub->fd, &msg, sizeof(msg), MSG_DONTWAIT);
+
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+    if (n != (ssize_t)sizeof(msg) || msg.magic != STREAM_MAGIC || sub->subscribed) {
+        drop_subscriber(sub);
+        return;
+    }
+
+    if (msg.decimation == 0) msg.decimation = 1;
+    if (msg.policy > STREAM_DISCONNECT) msg.policy = STREAM_DROP_OLDEST;
+    sub->sub = msg;
+    sub->subscribed = 1;
+    sub->last_flush = monotonic_sec();
+}
+
+/**
+ * @brief Queues one sample for a subscriber, applying its channel filter,
+ *        decimation and slow-client policy.
+ */
+static void enqueue_sample(stream_subscriber_t *sub, const stream_sample_t *s) {
+    if (!(sub->sub.channel_mask & (1u << s->channel))) return;
+    if (sub->decim_count[s->channel]++ % sub->sub.decimation != 0) return;
+
+    if (stream_ring_push(&sub->queue, *s)) return;
+
+    // Queue full: the subscriber is not keeping up
+    switch (sub->sub.policy) {
+        case STREAM_DROP_OLDEST:
+            stream_ring_discard(&sub->queue, 1);
+            stream_ring_push(&sub->queue, *s);
+            sub->dropped++;
+            break;
+        case STREAM_DROP_NEWEST:
+            sub->dropped++;
+            break;
+        default:
+            drop_subscriber(sub);
+            break;
+    }
+}
+
+/**
+ * @brief Sends queued samples as batched frames while the socket accepts them.
+ *        A frame is sent once STREAM_MAX_BATCH samples are queued or the
+ *        oldest pending data has waited STREAM_FLUSH_MS.
+ */
+static void flush_subscriber(stream_subscriber_t *sub, double now) {
+    struct {
+        stream_frame_header_t hdr;
+        stream_sample_t samples[STREAM_MAX_BATCH];
+    } frame;
+
+    while (sub->fd >= 0) {
+        uint32_t pending = stream_ring_count(&sub->queue);
+        if (pending == 0) return;
+        if (pending < STREAM_MAX_BATCH && (now - sub->last_flush) * 1000.0 < STREAM_FLUSH_MS) return;
+
+        uint32_t n = stream_ring_peek_bulk(&sub->queue, frame.samples, STREAM_MAX_BATCH);
+        frame.hdr.magic = STREAM_MAGIC;
+        frame.hdr.count = (uint16_t)n;
+        frame.hdr.reserved = 0;
+        frame.hdr.dropped = sub->dropped;
+        frame.hdr.reserved2 = 0;
+
+        size_t len = sizeof(frame.hdr) + n * sizeof(stream_sample_t);
+        ssize_t sent = send(sub->fd, &frame, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent < 0) {
+            // Socket buffer full: keep the data queued, the policy handles overflow
+            if (errno != EAGAIN && errno != EWOULDBLOCK) drop_subscriber(sub);
+            return;
+        }
+
+        stream_ring_discard(&sub->queue, n);
+        sub->dropped = 0;
+        sub->last_flush = now;
+    }
+}
+
+/**
+ * @brief Server thread: accepts subscribers, fans samples out from the ingress
+ *        ring into per-subscriber queues and sends batched frames.
+ *        All socket I/O happens here, never on the acquisition thread.
+ *
+ * The thread sleeps in poll() until a socket is ready, stream_server_publish()
+ * signals wake_fd, or a subscriber's partial batch reaches its flush deadline.
+ * With nothing pending the timeout is infinite, so an idle server does not wake up.
+ */
+static void *server_thread(void *arg) {
+    stream_server_t *srv = arg;
+    static stream_sample_t drained[STREAM_INGRESS_SIZE];
+
+    while (srv->running) {
+        struct pollfd fds[2 + STREAM_MAX_SUBSCRIBERS];
+        int map[2 + STREAM_MAX_SUBSCRIBERS];
+        int nfds = 0;
+        int timeout_ms = -1;
+        double now = monotonic_sec();
+
+        fds[nfds].fd = srv->wake_fd;
+        fds[nfds].events = POLLIN;
+        map[nfds++] = -1;
+        fds[nfds].fd = srv->listen_fd;
+        fds[nfds].events = POLLIN;
+        map[nfds++] = -1;
+        for (int i = 0; i < STREAM_MAX_SUBSCRIBERS; i++) {
+            stream_subscriber_t *sub = &srv->subs[i];
+            if (sub->fd < 0) continue;
+            fds[nfds].fd = sub->fd;
+            fds[nfds].events = POLLIN;
+            map[nfds++] = i;
+
+            if (stream_ring_is_empty(&sub->queue)) continue;
+            int wait_ms = (int)((sub->last_flush - now) * 1000.0) + STREAM_FLUSH_MS + 1;
+            if (wait_ms <= 0) {
+                // Due but the last send hit a full socket: wait until it drains
+                fds[nfds - 1].events |= POLLOUT;
+            } else if (timeout_ms < 0 || wait_ms < timeout_ms) {
+                timeout_ms = wait_ms;
+            }
+        }
+
+        poll(fds, nfds, timeout_ms);
+
+        if (fds[0].revents & POLLIN) {
+            uint64_t count;
+            ssize_t r = read(srv->wake_fd, &count, sizeof(count));  // Reset the counter
+            (void)r;
+        }
+        if (fds[1].revents & POLLIN) {
+            accept_subscriber(srv);
+        }
+        for (int k = 2; k < nfds; k++) {
+            stream_subscriber_t *sub = &srv->subs[map[k]];
+            if (fds[k].revents & (POLLHUP | POLLERR)) {
+                drop_subscriber(sub);
+            } else if (fds[k].revents & POLLIN) {
+                read_subscriber(sub);
+            }
+        }
+
+        // Take everything the acquisition thread published since the last pass
+        pthread_mutex_lock(&srv->ingress_lock);
+        uint32_t n = stream_ingress_pop_bulk(&srv->ingress, drained, STREAM_INGRESS_SIZE);
+        pthread_mutex_unlock(&srv->ingress_lock);
+
+        now = monotonic_sec();
+        for (int i = 0; i < STREAM_MAX_SUBSCRIBERS; i++) {
+            stream_subscriber_t *sub = &srv->subs[i];
+            if (sub->fd < 0 || !sub->subscribed) continue;
+            for (uint32_t j = 0; j < n && sub->fd >= 0; j++) {
+                enqueue_sample(sub, &drained[j]);
+            }
+            flush_subscriber(sub, now);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Creates the SOCK_SEQPACKET listening socket and starts the server thread.
+ *        Each frame keeps its message boundary, so clients read one whole batch per recv().
+ * @param srv  Server state (large; keep it static)
+ * @param path Socket path, e.g. STREAM_DEFAULT_PATH
+ * @return 0 on success, -1 on failure
+ */
+int stream_server_start(stream_server_t *srv, const char *path) {
+    memset(srv, 0, sizeof(*srv));
+    for (int i = 0; i < STREAM_MAX_SUBSCRIBERS; i++) {
+        srv->subs[i].fd = -1;
+    }
+    stream_ingress_init(&srv->ingress);
+    pthread_mutex_init(&srv->ingress_lock, NULL);
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(path) >= sizeof(addr.sun_path)) return -1;
+    strcpy(addr.sun_path, path);
+    strcpy(srv->path, path);
+
+    srv->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (srv->wake_fd < 0) {
+        perror("stream eventfd");
+        return -1;
+    }
+
+    srv->listen_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (srv->listen_fd < 0) {
+        perror("stream socket");
+        close(srv->wake_fd);
+        return -1;
+    }
+
+    unlink(path);  // Remove a stale socket from a previous run
+    if (bind(srv->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(srv->listen_fd, STREAM_MAX_SUBSCRIBERS) != 0) {
+        perror("stream bind/listen");
+        close(srv->listen_fd);
+        close(srv->wake_fd);
+        return -1;
+    }
+
+    srv->running = 1;
+    if (pthread_create(&srv->thread, NULL, server_thread, srv) != 0) {
+        srv->running = 0;
+        close(srv->listen_fd);
+        close(srv->wake_fd);
+        unlink(path);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Publishes one sample to all subscribers. Called from the acquisition loop:
+ *        it only copies into the ingress ring under a short lock and never blocks
+ *        on sockets, so a slow subscriber cannot stall sampling.
+ * @param srv     Server state
+ * @param channel Channel id (0..STREAM_MAX_CHANNELS-1)
+ * @param value   Sample value
+ * @param timestamp_us Capture time of the sample (CLOCK_REALTIME, microseconds);
+ *                     in --batch mode this is earlier than the publish time
+ */
+void stream_server_publish(stream_server_t *srv, uint8_t channel, float value, int64_t timestamp_us) {
+    if (!srv->running || channel >= STREAM_MAX_CHANNELS) return;
+
+    stream_sample_t s = {
+        .timestamp_us = timestamp_us,
+        .channel = channel,
+        .value = value
+    };
+
+    pthread_mutex_lock(&srv->ingress_lock);
+    s.seq = srv->seq[channel]++;
+    int was_empty = stream_ingress_is_empty(&srv->ingress);
+    stream_ingress_push(&srv->ingress, s);
+    pthread_mutex_unlock(&srv->ingress_lock);
+
+    // The thread drains the whole ring per pass, so a burst needs only one signal
+    if (was_empty) wake_server(srv);
+}
+
+/**
+ * @brief Stops the server thread, closes all connections and removes the socket file.
+ */
+void stream_server_stop(stream_server_t *srv) {
+    if (!srv->running) return;
+
+    srv->running = 0;
+    wake_server(srv);
+    pthread_join(srv->thread, NULL);
+
+    for (int i = 0; i < STREAM_MAX_SUBSCRIBERS; i++) {
+        if (srv->subs[i].fd >= 0) drop_subscriber(&srv->subs[i]);
+    }
+    close(srv->listen_fd);
+    close(srv->wake_fd);
+    unlink(srv->path);
+    pthread_mutex_destroy(&srv->ingress_lock);
+}
@@ -0,0 +1,150 @@
+#include "trend.h"
+#include <string.h> // for memset
+
+/**
+ * @brief Initializes a trend estimator.
+ * @param t     Estimator state
+ * @param alpha Holt level smoothing (0 disables Holt)
+ * @param beta  Holt trend smoothing
+ */
+void trend_init(trend_t *t, float alpha, float beta) {
+    memset(t, 0, sizeof(*t));
+    t->alpha = alpha;
+    t->beta = beta;
+}
+
+/**
+ * @brief Recomputes the running sums with the oldest sample as the new origin.
+ *        Done once per TREND_WINDOW samples, so it stays O(1) amortized and
+ *        keeps x small enough that n·Sxx − Sx² does not lose precision.
+ */
+static void rebase(trend_t *t) {
+    uint32_t oldest = (t->head - t->count) & (TREND_WINDOW - 1);
+    double shift = t->x[oldest];
+
+    t->origin += shift;
+    t->sx = t->sy = t->sxx = t->sxy = t->syy = 0.0;
+    for (uint32_t k = 0; k < t->count; k++) {
+        uint32_t i = (oldest + k) & (TREND_WINDOW - 1);
+        t->x[i] -= shift;
+        t->sx  += t->x[i];
+        t->sy  += t->y[i];
+        t->sxx += t->x[i] * t->x[i];
+        t->sxy += t->x[i] * t->y[i];
+        t->syy += t->y[i] * t->y[i];
+    }
+}
+
+/**
+ * @brief Holt's linear method with irregular sample spacing: the trend is
+ *        kept per second, so adaptive sampling periods do not skew it.
+ */
+static void holt_update(trend_t *t, float value, double now) {
+    if (!t->holt_started) {
+        t->level = value;
+        t->holt_slope = 0.0;
+        t->holt_started = 1;
+    } else {
+        double dt = now - t->last_time;
+        if (dt <= 0.0) return;
+        double prev = t->level;
+        t->level = t->alpha * value + (1.0 - t->alpha) * (prev + t->holt_slope * dt);
+        t->holt_slope = t->beta * (t->level - prev) / dt + (1.0 - t->beta) * t->holt_slope;
+    }
+    t->last_time = now;
+}
+
+/**
+ * @brief Adds a sample; the oldest one is evicted from the sums once the window is full.
+ * @param t     Estimator state
+ * @param value New sample
+ * @param now   Monotonic time in seconds
+ */
+void trend_add(trend_t *t, float value, double now) {
+    if (t->count == 0) {
+        t->origin = now;
+    }
+
+    if (t->count == TREND_WINDOW) {
+        uint32_t old = t->head;  // Oldest slot is the one about to be overwritten
+        t->sx  -= t->x[old];
+        t->sy  -= t->y[old];
+        t->sxx -= t->x[old] * t->x[old];
+        t->sxy -= t->x[old] * t->y[old];
+        t->syy -= t->y[old] * t->y[old];
+        t->count--;
+    }
+
+    double x = now - t->origin;
+    t->x[t->head] = x;
+    t->y[t->head] = value;
+    t->sx  += x;
+    t->sy  += value;
+    t->sxx += x * x;
+    t->sxy += x * value;
+    t->syy += (double)value * value;
+    t->head = (t->head + 1) & (TREND_WINDOW - 1);
+    t->count++;
+
+    if (t->head == 0) {
+        rebase(t);
+    }
+
+    if (t->alpha > 0.0f) {
+        holt_update(t, value, now);
+    }
+}
+
+/**
+ * @brief Returns the least-squares line through the current window.
+ *        Slope and R² are 0 until there are two samples at different times.
+ * @param t   Estimator state
+ * @param out Slope (units/s), value at the newest sample, R² and sample count
+ */
+void trend_fit(const trend_t *t, trend_fit_t *out) {
+    double n = t->count;
+    double dxx = n * t->sxx - t->sx * t->sx;
+    double dxy = n * t->sxy - t->sx * t->sy;
+    double dyy = n * t->syy - t->sy * t->sy;
+
+    out->n = t->count;
+    if (t->count < 2 || dxx <= 0.0) {
+        out->slope = 0.0f;
+        out->intercept = t->count ? (float)(t->sy / n) : 0.0f;
+        out->r2 = 0.0f;
+        return;
+    }
+
+    double slope = dxy / dxx;
+    double a = (t->sy - slope * t->sx) / n;
+    double x_last = t->x[(t->head - 1) & (TREND_WINDOW - 1)];
+
+    out->slope = (float)slope;
+    out->intercept = (float)(a + slope * x_last);
+    // A flat series is fitted exactly by a flat line
+    out->r2 = dyy > 0.0 ? (float)(dxy * dxy / (dxx * dyy)) : 1.0f;
+}
+
+/**
+ * @brief Holt forecast: smoothed level extrapolated by the smoothed trend.
+ * @param t         Estimator state
+ * @param horizon_s Seconds ahead of the last sample
+ * @return Forecast value (the last level if Holt is disabled or not started)
+ */
+float trend_holt_forecast(const trend_t *t, float horizon_s) {
+    return (float)(t->level + t->holt_slope * horizon_s);
+}
+
+/**
+ * @brief Copies the current trend into the stats_t trend fields (per minute),
+ *        so they are ready for printing and payload encoding without a rescan.
+ */
+void trend_fill_stats(const trend_t *t, stats_t *s) {
+    trend_fit_t fit;
+    trend_fit(t, &fit);
+    s->slope = fit.slope * 60.0f;
+    s->intercept = fit.intercept;
+    s->r2 = fit.r2;
+    s->holt_level = (float)t->level;
+    s->holt_slope = (float)(t->holt_slope * 60.0);
+}
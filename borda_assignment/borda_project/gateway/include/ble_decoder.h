@@ -0,0 +1,59 @@
+#ifndef BLE_DECODER_H
+#define BLE_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ble_payload.h"
+
+#define BLE_DEC_SENSORS     3      // temp, hum, CO₂ (payload order)
+#define BLE_DEC_DEDUP_BITS  64     // Sliding window of recently seen sequence numbers
+
+// Per-node reconstruction state (one entry per advertiser address)
+typedef struct {
+    uint64_t node_addr;
+    uint64_t seq;          // Highest reconstructed 64-bit sequence number
+    int64_t  timestamp;    // Timestamp of that packet, full UNIX seconds
+    uint64_t seen;         // Bit i set → packet (seq - i) already delivered
+    uint8_t  used;
+} ble_node_state_t;
+
+// Gateway-side decoder: fixed-size open-addressing node table
+typedef struct {
+    ble_node_state_t *nodes;
+    size_t capacity;       // Power of two
+    size_t node_count;
+    uint64_t duplicates;   // Repeated advertisements dropped
+    uint64_t stale;        // Packets older than the dedup window dropped
+    uint64_t table_full;   // Packets dropped because the node table was full
+} ble_decoder_t;
+
+// Decoded payloads, structure-of-arrays so per-field loops stay contiguous
+typedef struct {
+    size_t capacity;
+    size_t count;
+    uint64_t *node_addr;
+    uint64_t *seq;
+    int64_t  *timestamp;
+    float *std_dev[BLE_DEC_SENSORS];
+    float *max[BLE_DEC_SENSORS];
+    float *min[BLE_DEC_SENSORS];
+    float *median[BLE_DEC_SENSORS];
+    float *slope[BLE_DEC_SENSORS];   // Units per minute; 0 for payloads without trend fields
+} ble_batch_t;
+
+int  ble_decoder_init(ble_decoder_t *dec, size_t max_nodes);
+void ble_decoder_free(ble_decoder_t *dec);
+
+int  ble_batch_init(ble_batch_t *batch, size_t capacity);
+void ble_batch_free(ble_batch_t *batch);
+void ble_batch_clear(ble_batch_t *batch);
+
+size_t ble_decode_batch(ble_decoder_t *dec,
+                        const uint8_t *payloads,
+                        size_t stride,
+                        const uint64_t *node_addr,
+                        const int64_t *rx_time,
+                        size_t n,
+                        ble_batch_t *out);
+
+#endif // BLE_DECODER_H
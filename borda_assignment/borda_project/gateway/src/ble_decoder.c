@@ -0,0 +1,255 @@
+#include "ble_decoder.h"
+#include <stdlib.h> // for calloc, free
+#include <string.h> // for memset
+
+// Inverse of the fixed-point scales used by encode_ble_stats_fields()
+static const float INV_SCALE[BLE_DEC_SENSORS] = { 0.01f, 0.01f, 1.0f };
+
+/**
+ * @brief Mixes a 64-bit node address into a table index (splitmix64 finalizer).
+ */
+static inline uint64_t hash_addr(uint64_t x) {
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static inline uint16_t read_u16_le(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/**
+ * @brief Initializes the decoder with room for a fixed number of nodes.
+ *        The table is sized to the next power of two ≥ 2 × max_nodes to keep
+ *        linear probing chains short; it never grows at ingest time.
+ * @param dec       Decoder to initialize
+ * @param max_nodes Expected number of distinct advertisers
+ * @return 0 on success, -1 on allocation failure
+ */
+int ble_decoder_init(ble_decoder_t *dec, size_t max_nodes) {
+    memset(dec, 0, sizeof(*dec));
+
+    size_t cap = 16;
+    while (cap < max_nodes * 2) cap <<= 1;
+
+    dec->nodes = calloc(cap, sizeof(ble_node_state_t));
+    if (!dec->nodes) return -1;
+    dec->capacity = cap;
+    return 0;
+}
+
+/**
+ * @brief Releases the node table.
+ */
+void ble_decoder_free(ble_decoder_t *dec) {
+    free(dec->nodes);
+    dec->nodes = NULL;
+    dec->capacity = 0;
+}
+
+/**
+ * @brief Allocates all SoA columns of a batch.
+ * @param batch    Batch to initialize
+ * @param capacity Maximum number of decoded payloads per batch
+ * @return 0 on success, -1 on allocation failure
+ */
+int ble_batch_init(ble_batch_t *batch, size_t capacity) {
+    memset(batch, 0, sizeof(*batch));
+    batch->capacity = capacity;
+
+    batch->node_addr = malloc(capacity * sizeof(uint64_t));
+    batch->seq       = malloc(capacity * sizeof(uint64_t));
+    batch->timestamp = malloc(capacity * sizeof(int64_t));
+    int ok = batch->node_addr && batch->seq && batch->timestamp;
+
+    for (int s = 0; s < BLE_DEC_SENSORS; s++) {
+        batch->std_dev[s] = malloc(capacity * sizeof(float));
+        batch->max[s]     = malloc(capacity * sizeof(float));
+        batch->min[s]     = malloc(capacity * sizeof(float));
+        batch->median[s]  = malloc(capacity * sizeof(float));
+        batch->slope[s]   = malloc(capacity * sizeof(float));
+        ok = ok && batch->std_dev[s] && batch->max[s] && batch->min[s] && batch->median[s] &&
+             batch->slope[s];
+    }
+
+    if (!ok) {
+        ble_batch_free(batch);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Frees all SoA columns of a batch.
+ */
+void ble_batch_free(ble_batch_t *batch) {
+    free(batch->node_addr);
+    free(batch->seq);
+    free(batch->timestamp);
+    for (int s = 0; s < BLE_DEC_SENSORS; s++) {
+        free(batch->std_dev[s]);
+        free(batch->max[s]);
+        free(batch->min[s]);
+        free(batch->median[s]);
+        free(batch->slope[s]);
+    }
+    memset(batch, 0, sizeof(*batch));
+}
+
+/**
+ * @brief Empties a batch without freeing it, ready for the next ingest round.
+ */
+void ble_batch_clear(ble_batch_t *batch) {
+    batch->count = 0;
+}
+
+/**
+ * @brief Finds (or creates) the state entry for a node address.
+ * @return Pointer to the entry, or NULL if the table is full
+ */
+static ble_node_state_t *lookup_node(ble_decoder_t *dec, uint64_t addr) {
+    size_t mask = dec->capacity - 1;
+    size_t i = (size_t)hash_addr(addr) & mask;
+
+    for (size_t probe = 0; probe < dec->capacity; probe++) {
+        ble_node_state_t *n = &dec->nodes[i];
+        if (!n->used) {
+            // Keep the load factor ≤ 0.5 so lookups stay O(1)
+            if (dec->node_count * 2 >= dec->capacity) return NULL;
+            n->used = 1;
+            n->node_addr = addr;
+            dec->node_count++;
+            return n;
+        }
+        if (n->node_addr == addr) return n;
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Reconstructs the full UNIX timestamp from the 16-bit payload value.
+ *        Picks the value congruent to raw (mod 65536) nearest to the gateway's
+ *        receive time, so up to ±9 h of node clock skew is tolerated.
+ */
+static inline int64_t reconstruct_timestamp(uint16_t raw, int64_t rx_time) {
+    int16_t d = (int16_t)(raw - (uint16_t)rx_time);
+    return rx_time + d;
+}
+
+/**
+ * @brief Updates node state for one packet and decides whether to keep it.
+ *
+ * The 8-bit counter is unwrapped against the node's highest sequence number
+ * as a signed distance in [-128, 127]. If the packet looks older by counter
+ * but its reconstructed timestamp is newer than anything seen, the counter
+ * has wrapped during a silent period and the distance is moved forward by 256.
+ * A 64-entry bitmap then rejects repeats of recently delivered packets.
+ *
+ * @param node    Node state
+ * @param counter Raw payload counter (byte 0)
+ * @param ts      Reconstructed timestamp
+ * @param seq_out Reconstructed 64-bit sequence number
+ * @return 1 = new packet, 0 = duplicate, -1 = older than the dedup window
+ */
+static int accept_packet(ble_node_state_t *node, uint8_t counter, int64_t ts, uint64_t *seq_out) {
+    if (node->seen == 0) {
+        // First packet from this node: align the sequence with its counter
+        node->seq = counter;
+        node->timestamp = ts;
+        node->seen = 1;
+        *seq_out = node->seq;
+        return 1;
+    }
+
+    int delta = (int8_t)(counter - (uint8_t)node->seq);
+    if (delta <= 0 && ts > node->timestamp) {
+        delta += 256;
+    }
+
+    if (delta > 0) {
+        node->seen = (delta >= BLE_DEC_DEDUP_BITS) ? 0 : node->seen << delta;
+        node->seen |= 1;
+        node->seq += (uint64_t)delta;
+        node->timestamp = ts;
+        *seq_out = node->seq;
+        return 1;
+    }
+
+    int age = -delta;
+    if (age >= BLE_DEC_DEDUP_BITS || (uint64_t)age > node->seq) return -1;
+
+    uint64_t bit = 1ULL << age;
+    if (node->seen & bit) return 0;
+
+    // Late (reordered) packet that was never delivered
+    node->seen |= bit;
+    *seq_out = node->seq - (uint64_t)age;
+    return 1;
+}
+
+/**
+ * @brief Decodes a batch of raw advertising payloads into SoA columns.
+ *
+ * Payloads are packed back to back, `stride` bytes apart: BLE_PAYLOAD_SIZE
+ * for plain payloads or BLE_PAYLOAD_TREND_SIZE when the node runs with
+ * --trend. Trend slopes are decoded only when the stride covers them and are
+ * 0 otherwise; any bytes past the known fields are skipped. Repeated
+ * advertisements are dropped, and each remaining payload gets a 64-bit
+ * per-node sequence number and full UNIX timestamp. Decoding stops early if
+ * the output batch is full.
+ *
+ * @param dec       Decoder state (per-node tables)
+ * @param payloads  Packed raw payloads
+ * @param stride    Bytes per payload (≥ BLE_PAYLOAD_SIZE)
+ * @param node_addr Advertiser address of each payload (e.g. BLE MAC as integer)
+ * @param rx_time   Gateway receive time of each payload (UNIX seconds)
+ * @param n         Number of payloads
+ * @param out       Output batch; decoded entries are appended
+ * @return Number of payloads consumed from the input (0 if stride is too small)
+ */
+size_t ble_decode_batch(ble_decoder_t *dec,
+                        const uint8_t *payloads,
+                        size_t stride,
+                        const uint64_t *node_addr,
+                        const int64_t *rx_time,
+                        size_t n,
+                        ble_batch_t *out) {
+    if (stride < BLE_PAYLOAD_SIZE) return 0;
+    int has_trend = stride >= BLE_PAYLOAD_TREND_SIZE;
+
+    size_t i;
+    for (i = 0; i < n && out->count < out->capacity; i++) {
+        const uint8_t *p = payloads + i * stride;
+
+        ble_node_state_t *node = lookup_node(dec, node_addr[i]);
+        if (!node) {
+            dec->table_full++;
+            continue;
+        }
+
+        int64_t ts = reconstruct_timestamp(read_u16_le(p + 1), rx_time[i]);
+        uint64_t seq;
+        int verdict = accept_packet(node, p[0], ts, &seq);
+        if (verdict == 0) { dec->duplicates++; continue; }
+        if (verdict < 0)  { dec->stale++;      continue; }
+
+        size_t k = out->count++;
+        out->node_addr[k] = node_addr[i];
+        out->seq[k]       = seq;
+        out->timestamp[k] = ts;
+
+        for (int s = 0; s < BLE_DEC_SENSORS; s++) {
+            const uint8_t *f = p + 3 + s * 8;
+            float inv = INV_SCALE[s];
+            out->std_dev[s][k] = read_u16_le(f)     * inv;
+            out->max[s][k]     = read_u16_le(f + 2) * inv;
+            out->min[s][k]     = read_u16_le(f + 4) * inv;
+            out->median[s][k]  = read_u16_le(f + 6) * inv;
+            out->slope[s][k]   = has_trend
+                ? (int16_t)read_u16_le(p + BLE_PAYLOAD_SIZE + s * 2) * inv : 0.0f;
+        }
+    }
+    return i;
+}
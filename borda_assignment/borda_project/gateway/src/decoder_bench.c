@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ble_decoder.h"
+#include "stats.h"
+
+#define DEFAULT_NODES     2000
+#define DEFAULT_ROUNDS    600      // > 256 so every node's counter wraps at least twice
+#define DEFAULT_REPEATS   3        // Each advertisement is heard this many times
+#define BATCH_SIZE        4096     // Payloads handed to the decoder per call
+#define PAYLOAD_PERIOD_S  3        // Matches BLE_UPDATE_INTERVAL_SEC on the node
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Synthetic per-minute slope for a node, so decoded trend fields can be checked.
+ */
+static const float SLOPE_LSB[3] = { 0.01f, 0.01f, 1.0f };   // Trend field resolution per sensor
+
+static float node_slope(int n, int sensor) {
+    return (float)(n % 21 - 10) * SLOPE_LSB[sensor];
+}
+
+/**
+ * @brief Builds a synthetic gateway capture: every node publishes one payload per
+ *        round, each heard `repeats` times, with per-node counters
+ *        starting at random offsets so wraparound happens at different rounds.
+ *        Payloads are `stride` bytes; trend fields are filled when they fit.
+ */
+static void build_capture(uint8_t *payloads, size_t stride, uint64_t *addr, int64_t *rx_time,
+                          int nodes, int rounds, int repeats, int64_t t0) {
+    uint8_t *counters = malloc(nodes);
+    for (int n = 0; n < nodes; n++) counters[n] = (uint8_t)(rand() & 0xFF);
+
+    size_t k = 0;
+    for (int r = 0; r < rounds; r++) {
+        int64_t t = t0 + (int64_t)r * PAYLOAD_PERIOD_S;
+        for (int n = 0; n < nodes; n++) {
+            stats_t temp = { .min = 20.0f + n % 10 * 0.2f, .max = 25.0f, .mean = 22.5f,
+                             .std_dev = 0.3f, .median = 22.4f, .slope = node_slope(n, 0) };
+            stats_t hum  = { .min = 40.0f, .max = 60.0f, .mean = 50.0f,
+                             .std_dev = 2.0f, .median = 49.5f, .slope = node_slope(n, 1) };
+            stats_t co2  = { .min = 400.0f, .max = 600.0f, .mean = 500.0f,
+                             .std_dev = 20.0f, .median = 480.0f + r % 50, .slope = node_slope(n, 2) };
+
+            uint8_t p[BLE_PAYLOAD_TREND_SIZE];
+            encode_ble_stats_fields(p, &temp, &hum, &co2);
+            if (stride >= BLE_PAYLOAD_TREND_SIZE) encode_ble_trend_fields(p, &temp, &hum, &co2);
+            p[0] = counters[n]++;
+            p[1] = (uint8_t)(t & 0xFF);
+            p[2] = (uint8_t)((t >> 8) & 0xFF);
+
+            for (int d = 0; d < repeats; d++) {
+                memcpy(payloads + k * stride, p, stride);
+                addr[k] = 0xB827EB000000ULL + (uint64_t)n;  // Raspberry Pi OUI + node index
+                rx_time[k] = t + d;                         // Repeats arrive over a few seconds
+                k++;
+            }
+        }
+    }
+    free(counters);
+}
+
+/**
+ * @brief Checks the decoded slopes of a batch against node_slope().
+ *        The encoder truncates toward zero, so one LSB of error is allowed.
+ * @return Number of mismatching payloads
+ */
+static size_t check_slopes(const ble_batch_t *batch, int has_trend) {
+    size_t bad = 0;
+    for (size_t k = 0; k < batch->count; k++) {
+        int n = (int)(batch->node_addr[k] - 0xB827EB000000ULL);
+        for (int s = 0; s < BLE_DEC_SENSORS; s++) {
+            float expect = has_trend ? node_slope(n, s) : 0.0f;
+            float diff = batch->slope[s][k] - expect;
+            float tol = SLOPE_LSB[s] * 1.01f;
+            if (diff > tol || diff < -tol) { bad++; break; }
+        }
+    }
+    return bad;
+}
+
+/**
+ * @brief Runs one decode pass over a synthetic capture of `stride`-byte payloads.
+ * @return 0 if every unique payload was decoded with correct trend fields, 1 otherwise
+ */
+static int run_case(int nodes, int rounds, int repeats, size_t stride) {
+    size_t total = (size_t)nodes * rounds * repeats;
+    int has_trend = stride >= BLE_PAYLOAD_TREND_SIZE;
+
+    uint8_t  *payloads = malloc(total * stride);
+    uint64_t *addr     = malloc(total * sizeof(uint64_t));
+    int64_t  *rx_time  = malloc(total * sizeof(int64_t));
+    if (!payloads || !addr || !rx_time) {
+        fprintf(stderr, "❌ Out of memory for %zu payloads\n", total);
+        return 1;
+    }
+
+    srand(1);
+    // Start 900 s before the 16-bit timestamp wraps so reconstruction is exercised
+    int64_t t0 = (1743800000LL | 0xFFFF) + 1 - 900;
+    build_capture(payloads, stride, addr, rx_time, nodes, rounds, repeats, t0);
+
+    ble_decoder_t dec;
+    ble_batch_t batch;
+    if (ble_decoder_init(&dec, nodes) != 0 || ble_batch_init(&batch, BATCH_SIZE) != 0) {
+        fprintf(stderr, "❌ Decoder allocation failed\n");
+        return 1;
+    }
+
+    size_t decoded = 0, bad_slopes = 0;
+    uint64_t max_seq_span = 0;
+    double start = now_sec();
+
+    for (size_t off = 0; off < total; ) {
+        ble_batch_clear(&batch);
+        size_t n = total - off < BATCH_SIZE ? total - off : BATCH_SIZE;
+        off += ble_decode_batch(&dec, payloads + off * stride, stride, addr + off, rx_time + off, n, &batch);
+        decoded += batch.count;
+        if (batch.count && batch.seq[batch.count - 1] > max_seq_span)
+            max_seq_span = batch.seq[batch.count - 1];
+        bad_slopes += check_slopes(&batch, has_trend);
+    }
+
+    double elapsed = now_sec() - start;
+
+    printf("\n📐 Payload format : %zu bytes%s\n", stride, has_trend ? " (with trend fields)" : "");
+    printf("📦 Input payloads : %zu (%d nodes × %d rounds × %d repeats)\n", total, nodes, rounds, repeats);
+    printf("✅ Decoded unique : %zu (expected %zu)\n", decoded, (size_t)nodes * rounds);
+    printf("🔁 Duplicates     : %llu  Stale: %llu  Table full: %llu\n",
+           (unsigned long long)dec.duplicates, (unsigned long long)dec.stale,
+           (unsigned long long)dec.table_full);
+    printf("🔢 Max 64-bit seq : %llu (8-bit counter unwrapped)\n", (unsigned long long)max_seq_span);
+    printf("📈 Slope errors   : %zu\n", bad_slopes);
+    printf("⚡ Throughput     : %.2f M payloads/s (%.3f s)\n", total / elapsed / 1e6, elapsed);
+
+    ble_batch_free(&batch);
+    ble_decoder_free(&dec);
+    free(payloads);
+    free(addr);
+    free(rx_time);
+
+    return decoded == (size_t)nodes * rounds && bad_slopes == 0 ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    int nodes   = argc > 1 ? atoi(argv[1]) : DEFAULT_NODES;
+    int rounds  = argc > 2 ? atoi(argv[2]) : DEFAULT_ROUNDS;
+    int repeats = argc > 3 ? atoi(argv[3]) : DEFAULT_REPEATS;
+
+    int failed = run_case(nodes, rounds, repeats, BLE_PAYLOAD_SIZE);
+    failed |= run_case(nodes, rounds, repeats, BLE_PAYLOAD_TREND_SIZE);
+    return failed;
+}